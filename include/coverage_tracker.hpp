@@ -0,0 +1,65 @@
+#pragma once
+
+#include <drake/planning/collision_checker.h>
+#include <drake/geometry/optimization/hpolyhedron.h>
+
+#include <Eigen/Dense>
+
+#include <vector>
+#include <functional>
+#include <optional>
+#include <random>
+
+namespace GBurIRIS {
+
+    // Fixed pool of collision-free samples with a covered bitmap. Coverage is the fraction of covered samples, so
+    // adding a region only tests the samples that are still uncovered against it.
+    class CoverageTracker {
+
+    public:
+        CoverageTracker(
+            const drake::planning::CollisionChecker& collisionChecker,
+            int numOfSamples,
+            const std::function<Eigen::VectorXd ()>& randomConfigGenerator
+        );
+        // Marks the uncovered samples inside the region as covered and returns the new coverage
+        double addRegion(const drake::geometry::optimization::HPolyhedron& region);
+        double getCoverage() const;
+        // Samples, one per column
+        const Eigen::MatrixXd& getSamples() const;
+        // Indices of the samples not contained in any added region
+        const std::vector<int>& getUncoveredSamples() const;
+        bool isCovered(int sampleNumber) const;
+        // Picks an uncovered sample that has not been drawn before, either uniformly at random with randomEngine (the
+        // samples may be correlated, e.g. successive hit-and-run samples, so the sampling order is not random) or
+        // the one farthest from the added regions, and returns its index (std::nullopt if there is none). Drawn
+        // samples still count towards the coverage, so the tracker used for the coverage estimate should not also
+        // supply the drawn samples.
+        std::optional<int> drawUncoveredSample(std::mt19937& randomEngine, bool farthestFromRegions = false);
+
+    private:
+        Eigen::MatrixXd samples;
+        std::vector<bool> covered;
+        std::vector<bool> drawn;
+        std::vector<int> uncoveredSamples;
+        // Lower bound on the distance of every sample to the added regions: the min. over the regions of the largest
+        // normalized constraint violation
+        Eigen::VectorXd regionDistances;
+    };
+
+    inline double CoverageTracker::getCoverage() const {
+        return 1 - double(uncoveredSamples.size()) / double(samples.cols());
+    }
+
+    inline const Eigen::MatrixXd& CoverageTracker::getSamples() const {
+        return samples;
+    }
+
+    inline const std::vector<int>& CoverageTracker::getUncoveredSamples() const {
+        return uncoveredSamples;
+    }
+
+    inline bool CoverageTracker::isCovered(int sampleNumber) const {
+        return covered.at(sampleNumber);
+    }
+}
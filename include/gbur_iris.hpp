@@ -1,18 +1,42 @@
 #pragma once
 
 #include <drake/geometry/optimization/hyperellipsoid.h>
+#include <drake/geometry/optimization/affine_ball.h>
 #include <drake/planning/collision_checker.h>
 #include <drake/geometry/optimization/hpolyhedron.h>
+#include <drake/geometry/optimization/iris.h>
 #include <vector>
+#include <memory>
 #include <Eigen/Dense>
 #include "generalized_bur.hpp"
+#include "coverage_tracker.hpp"
 #include <tuple>
+#include <optional>
+#include <stdexcept>
 
 namespace GBurIRIS {
 
+    // drake solves the conic program of AffineBall::MinimumVolumeCircumscribedEllipsoid, khachiyan runs
+    // KhachiyanMinVolumeEllipsoid
+    enum class MinVolumeEllipsoidSolver { drake, khachiyan };
+
+    // Khachiyan's algorithm with Todd-Yildirim away steps, run on the affine hull of the points (one point per
+    // column), so degenerate point sets give a degenerate ellipsoid as with Drake. The result is scaled to contain
+    // every point. tolerance bounds the relative violation of the optimality conditions.
+    drake::geometry::optimization::AffineBall KhachiyanMinVolumeEllipsoid(
+        const Eigen::Ref<const Eigen::MatrixXd>& points,
+        double tolerance = 1e-6,
+        int maxIterations = 1000,
+        double rankTolerance = 1e-6
+    );
+
+    // points holds one point per column. With crossCheck, the ellipsoid is also computed by the other solver and
+    // a std::runtime_error is thrown if the two disagree.
     drake::geometry::optimization::Hyperellipsoid MinVolumeEllipsoid(
         const drake::planning::CollisionChecker& collisionChecker,
-        const std::vector<Eigen::VectorXd>& points
+        const Eigen::Ref<const Eigen::MatrixXd>& points,
+        MinVolumeEllipsoidSolver minVolumeEllipsoidSolver = MinVolumeEllipsoidSolver::drake,
+        bool crossCheck = false
     );
 
     drake::geometry::optimization::HPolyhedron InflatePolytope(
@@ -22,16 +46,79 @@ namespace GBurIRIS {
     );
 
 
+    // Wall-clock time spent in the inflation backend, in seconds
+    struct InflationStats {
+        int numOfInflations{};
+        double totalTime{};
+        double maxTime{};
+    };
+
+
+    // Defined in inflation_backend.hpp, so that only the users of the backends pull in the Drake IRIS headers
+    class InflationBackend;
+
+
+    // rejectionSampling draws random configurations until one is collision-free and outside every region. The other
+    // options draw from the uncovered samples of a pool of numOfBurCenterCandidates collision-free samples, kept
+    // apart from the coverage samples (uniformly at random, seeded by burCenterSelectionSeed, or the one with the
+    // largest lower bound on its distance to the regions), and only fall back to rejection sampling once every
+    // uncovered candidate has been drawn. The pool costs numOfBurCenterCandidates extra collision checked samples.
+    enum class BurCenterSelection { rejectionSampling, uncoveredSample, farthestUncoveredSample };
+
+
     struct GBurIRISConfig {
         int numOfSpines{ 7 };
         int burOrder{ 4 };
         double minDistanceTol{ 1e-5 };
         double phiTol{ 0.1 };
+        // Forwarded to the GeneralizedBurConfig of every bur
+        std::optional<double> obstacleDistanceCutoff{ std::nullopt };
+        int numOfThreads{ 1 };
+        GBur::SpineStepSolver spineStepSolver{ GBur::SpineStepSolver::fixedPoint };
+        int maxSpineStepIterations{ 100 };
+        int exactDistanceRefreshPeriod{ 0 };
+        double exactDistanceRefreshRatio{ 0 };
         int numPointsCoverageCheck{ 5000 };
+        // Coverage is tracked on one pool of numPointsCoverageCheck samples drawn up front (see CoverageTracker)
+        // instead of a fresh CheckCoverage every iteration
+        bool incrementalCoverage{ false };
+        BurCenterSelection burCenterSelection{ BurCenterSelection::rejectionSampling };
+        int numOfBurCenterCandidates{ 1000 };
+        unsigned int burCenterSelectionSeed{ 0 };
         double coverage{ 0.7 };
         int numOfIter{ 100 };
         int numOfIterIRIS{ 1 };
+        // Draw a new bur center instead of failing when the inflation backend throws an InfeasibleSeedError
         bool ignoreDeltaExceptionFromIRISNP{ true };
+        // When false, GBurIRIS returns no bur results, which keeps memory flat over long runs
+        bool retainBurs{ true };
+        // When set, obstacle planes are shared between burs through an ObstaclePlaneCache with this search radius
+        std::optional<double> obstaclePlaneCacheSearchRadius{ std::nullopt };
+        double obstaclePlaneCacheAcceptanceRatio{ 0.5 };
+        int obstaclePlaneCacheMaxNumOfEntries{ 1000 };
+        MinVolumeEllipsoidSolver minVolumeEllipsoidSolver{ MinVolumeEllipsoidSolver::drake };
+        bool crossCheckMinVolumeEllipsoid{ false };
+        // Shared so that copies of the config accumulate stats on the same backend. When null, an IrisNpBackend is
+        // built from numOfIterIRIS. GBurIRIS returns the stats of the backend, which include earlier runs on it
+        // unless they are reset.
+        std::shared_ptr<InflationBackend> inflationBackend{ nullptr };
+    };
+
+
+    // Compact, move-only record of a bur that produced a region
+    struct BurResult {
+        Eigen::VectorXd center;
+        // Outermost layer, one point per column
+        Eigen::MatrixXd outerLayer;
+        double minDistanceToCollision;
+        // Mean configuration space distance from the center to the outer layer points
+        double meanSpineLength;
+
+        BurResult(Eigen::VectorXd center, Eigen::MatrixXd outerLayer, double minDistanceToCollision);
+        BurResult(const BurResult&) = delete;
+        BurResult& operator=(const BurResult&) = delete;
+        BurResult(BurResult&&) = default;
+        BurResult& operator=(BurResult&&) = default;
     };
 
 
@@ -46,7 +133,8 @@ namespace GBurIRIS {
     std::tuple<
         std::vector<drake::geometry::optimization::HPolyhedron>,
         double,
-        std::vector<GBur::GeneralizedBur>
+        std::vector<BurResult>,
+        InflationStats
     > GBurIRIS(
         robots::Robot& robot,
         const GBurIRISConfig& gBurIRISConfig,
@@ -57,7 +145,8 @@ namespace GBurIRIS {
     std::tuple<
         std::vector<drake::geometry::optimization::HPolyhedron>,
         double,
-        std::vector<GBur::GeneralizedBur>
+        std::vector<BurResult>,
+        InflationStats
     > GBurIRIS(
         robots::Robot& robot,
         GBurIRISConfig gBurIRISConfig,
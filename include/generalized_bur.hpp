@@ -1,10 +1,13 @@
 #pragma once
 
 #include "robot.hpp"
+#include "obstacle_plane_cache.hpp"
+#include "thread_pool.hpp"
 
 #include <Eigen/Dense>
 
 #include <functional>
+#include <memory>
 #include <optional>
 #include <vector>
 #include <tuple>
@@ -14,17 +17,40 @@
 
 namespace GBurIRIS::GBur {
 
+    // fixedPoint takes the largest step certified by the radii at the current spine point. secant extrapolates the
+    // displacement with a secant step, accepts it if the bounds at both ends certify the segment in between and
+    // otherwise bisects back towards the fixed-point step.
+    enum class SpineStepSolver { fixedPoint, secant };
+
+
     struct GeneralizedBurConfig {
         int numOfSpines{ 7 };
         int burOrder{ 3 };
         double minDistanceTol{ 1e-5 };
         double phiTol{ 0.1 };
+        // Robot-obstacle pairs farther apart than the cutoff are not queried; their distance is underestimated by the
+        // cutoff minus a bound on how far the robot collision geometry moved from the queried configuration.
+        std::optional<double> obstacleDistanceCutoff{ std::nullopt };
+        // Spines are computed concurrently on this many threads (including the calling one), unless a ThreadPool is
+        // set with setThreadPool
+        int numOfThreads{ 1 };
+        SpineStepSolver spineStepSolver{ SpineStepSolver::fixedPoint };
+        // Max. number of robot evaluations per layer of a spine
+        int maxSpineStepIterations{ 100 };
+        // The min. distance of a layer point is recomputed exactly (instead of from the obstacle planes at the bur
+        // center) every exactDistanceRefreshPeriod layers and whenever the plane underestimation drops below
+        // exactDistanceRefreshRatio times the min. distance of the previous layer point. Zero disables either rule.
+        int exactDistanceRefreshPeriod{ 0 };
+        double exactDistanceRefreshRatio{ 0 };
     };
 
 
     class GeneralizedBur {
 
     public:
+        // Non-owning view of bur points stored as columns of the layer buffer
+        using LayerView = Eigen::Map<const Eigen::MatrixXd, 0, Eigen::OuterStride<>>;
+
         GeneralizedBur(
             const Eigen::VectorXd& qCenter,
             const GeneralizedBurConfig& generalizedBurConfig,
@@ -44,10 +70,21 @@ namespace GBurIRIS::GBur {
             const Eigen::MatrixXd& rotationMatrix
         );
         double getMinDistanceToCollision();
-        std::tuple<std::vector<Eigen::VectorXd>, std::vector<std::vector<Eigen::VectorXd>>> calculateBur();
+        // Returns references to the spine end points and the layer buffer owned by the bur
+        std::tuple<const std::vector<Eigen::VectorXd>&, const Eigen::MatrixXd&> calculateBur();
         GeneralizedBurConfig getGeneralizedBurConfig() const;
-        std::vector<std::vector<Eigen::VectorXd>> getLayers() const;
+        // Column spineNumber * (burOrder + 1) + layerNumber holds the given layer point of the given spine
+        const Eigen::MatrixXd& getLayers() const;
+        // Points of the given layer, one column per spine
+        LayerView getLayer(int layerNumber) const;
+        // Points of the given spine, one column per layer
+        LayerView getSpine(int spineNumber) const;
         void setRandomConfigs(const std::vector<Eigen::VectorXd>& randomConfigs);
+        // Obstacle planes are looked up in (and fresh queries stored to) the cache, which has to outlive the bur
+        void setObstaclePlaneCache(ObstaclePlaneCache& obstaclePlaneCache);
+        // Spines are then computed on the workers of the pool, which has to outlive the bur, instead of on
+        // numOfThreads threads started for this bur
+        void setThreadPool(ThreadPool& threadPool);
         Eigen::VectorXd getCenter() const;
 
     private:
@@ -58,44 +95,113 @@ namespace GBurIRIS::GBur {
         std::optional<Eigen::MatrixXd> rotationMatrix{ std::nullopt };
         std::optional<std::vector<Eigen::VectorXd>> randomConfigs{ std::nullopt };
         std::optional<double> minDistance{ std::nullopt };
-        std::optional<std::vector<
-            std::tuple<drake::multibody::BodyIndex, drake::multibody::BodyIndex, Eigen::Vector3d, Eigen::Vector3d, double>
-        >> linkObstacleDistancePairs{ std::nullopt };
-        std::optional<std::vector<Eigen::Vector4d>> linkObstaclePlanes{ std::nullopt };
-        std::vector<std::vector<Eigen::VectorXd>> layers;
+        std::optional<std::vector<LinkObstacleDistancePair>> linkObstacleDistancePairs{ std::nullopt };
+        // Configuration at which linkObstacleDistancePairs were queried (the bur center unless reused from the cache)
+        Eigen::VectorXd obstacleQueryConfiguration;
+        // Enclosing radii at obstacleQueryConfiguration, only computed when obstacleDistanceCutoff is set
+        std::vector<double> obstacleQueryEnclosingRadii;
+        ObstaclePlaneCache* obstaclePlaneCache{ nullptr };
+        ThreadPool* threadPool{ nullptr };
+        // Obstacle planes n.x + c = 0 with unit normals pointing from the robot to the obstacle, grouped by link: the
+        // planes of link i occupy rows linkObstaclePlaneStartRows[i] to linkObstaclePlaneStartRows[i + 1] - 1.
+        Eigen::MatrixX3d linkObstaclePlaneNormals;
+        Eigen::VectorXd linkObstaclePlaneConstants;
+        std::vector<int> linkObstaclePlaneStartRows;
+        Eigen::MatrixXd layers;
 
         void approximateObstaclesWithPlanes();
-        double getMinDistanceUnderestimation(const Eigen::VectorXd& q);
-        double evaluatePhiFunction(
-            double distance,
-            double t,
-            const Eigen::VectorXd& qe,
-            const Eigen::VectorXd& startingPoint
+        void buildLinkObstaclePlanes();
+        // Compensated distances between both endpoints of the link and its obstacle planes (one row per plane)
+        Eigen::ArrayXXd calculateLinkObstaclePlaneDistances(
+            const Eigen::Ref<const Eigen::MatrixXd>& linkPositions,
+            int linkNumber
+        ) const;
+        // Lower bound on the min. distance at q from the obstacle planes alone, or std::nullopt if some link is not
+        // entirely on the robot side of all its planes
+        std::optional<double> calculateCertifiedPlaneDistance(const Eigen::Ref<const Eigen::VectorXd>& q) const;
+        double getMinDistanceUnderestimation(const Eigen::Ref<const Eigen::VectorXd>& q);
+        // Upper bound on how far any point of the robot collision geometry moves between obstacleQueryConfiguration
+        // and q: the smaller of the enclosing radii bound and the link position displacement plus twice the largest
+        // link geometry compensation (the geometry may turn around the link, e.g. under a wrist roll)
+        double calculateMaxGeometryDisplacement(const Eigen::Ref<const Eigen::VectorXd>& q) const;
+        bool isLinkObstaclePair(
+            const drake::multibody::RigidBody<double>& bodyA,
+            const drake::multibody::RigidBody<double>& bodyB
+        ) const;
+        // Exact min. distance between the robot links and the obstacles at q, evaluated on a standalone collision
+        // checker context (created on first use) so that concurrent spines do not share the implicit context
+        double calculateMinDistanceToCollision(
+            const Eigen::Ref<const Eigen::VectorXd>& q,
+            std::shared_ptr<drake::planning::CollisionCheckerContext>& collisionCheckerContext
+        ) const;
+        // Min. distance of the point reached by the given layer, applying the exact distance refresh policy
+        double calculateLayerMinDistance(
+            const Eigen::Ref<const Eigen::VectorXd>& q,
+            int layerNumber,
+            double previousMinDistance,
+            std::shared_ptr<drake::planning::CollisionCheckerContext>& collisionCheckerContext
         );
+        void calculateSpines();
+        // Return the layer point reached from startingPoint towards qe within the given min. distance
+        Eigen::VectorXd calculateLayerPointFixedPoint(
+            const Eigen::Ref<const Eigen::VectorXd>& startingPoint,
+            const Eigen::Ref<const Eigen::VectorXd>& qe,
+            const Eigen::Ref<const Eigen::VectorXd>& qLowerBounds,
+            const Eigen::Ref<const Eigen::VectorXd>& qUpperBounds,
+            double minDistance
+        ) const;
+        Eigen::VectorXd calculateLayerPointSecant(
+            const Eigen::Ref<const Eigen::VectorXd>& startingPoint,
+            const Eigen::Ref<const Eigen::VectorXd>& qe,
+            const Eigen::Ref<const Eigen::VectorXd>& qLowerBounds,
+            const Eigen::Ref<const Eigen::VectorXd>& qUpperBounds,
+            double minDistance
+        ) const;
+        int getLayerColumn(int spineNumber, int layerNumber) const;
     };
 
-    inline double GeneralizedBur::evaluatePhiFunction(
-        double distance,
-        double t,
-        const Eigen::VectorXd& qe,
-        const Eigen::VectorXd& startingPoint
-    ) {
-        return distance - robot.getMaxDisplacement(startingPoint, startingPoint + t * (qe - startingPoint));
-    }
-
-
     inline GeneralizedBurConfig GeneralizedBur::getGeneralizedBurConfig() const {
         return generalizedBurConfig;
     }
 
-    inline std::vector<std::vector<Eigen::VectorXd>> GeneralizedBur::getLayers() const {
+    inline const Eigen::MatrixXd& GeneralizedBur::getLayers() const {
         return layers;
     }
 
+    inline GeneralizedBur::LayerView GeneralizedBur::getLayer(int layerNumber) const {
+        return LayerView(
+            layers.col(layerNumber).data(),
+            layers.rows(),
+            generalizedBurConfig.numOfSpines,
+            Eigen::OuterStride<>(layers.rows() * (generalizedBurConfig.burOrder + 1))
+        );
+    }
+
+    inline GeneralizedBur::LayerView GeneralizedBur::getSpine(int spineNumber) const {
+        return LayerView(
+            layers.col(getLayerColumn(spineNumber, 0)).data(),
+            layers.rows(),
+            generalizedBurConfig.burOrder + 1,
+            Eigen::OuterStride<>(layers.rows())
+        );
+    }
+
+    inline int GeneralizedBur::getLayerColumn(int spineNumber, int layerNumber) const {
+        return spineNumber * (generalizedBurConfig.burOrder + 1) + layerNumber;
+    }
+
     inline void GeneralizedBur::setRandomConfigs(const std::vector<Eigen::VectorXd>& randomConfigs) {
         this->randomConfigs = randomConfigs;
     }
 
+    inline void GeneralizedBur::setObstaclePlaneCache(ObstaclePlaneCache& obstaclePlaneCache) {
+        this->obstaclePlaneCache = &obstaclePlaneCache;
+    }
+
+    inline void GeneralizedBur::setThreadPool(ThreadPool& threadPool) {
+        this->threadPool = &threadPool;
+    }
+
     inline Eigen::VectorXd GeneralizedBur::getCenter() const {
         return qCenter;
     }
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <drake/geometry/optimization/hyperellipsoid.h>
+#include <drake/geometry/optimization/hpolyhedron.h>
+#include <drake/planning/iris/iris_np2.h>
+#include <drake/planning/iris/iris_zo.h>
+#include "generalized_bur.hpp"
+#include "gbur_iris.hpp"
+#include "robot.hpp"
+#include <stdexcept>
+
+namespace GBurIRIS {
+
+    // Thrown by an InflationBackend when the center of the ellipsoid is not a valid seed (in collision, outside the
+    // domain, or within the configuration space margin of IRIS-NP), so that GBurIRIS can draw a new bur center. Other
+    // errors of the Drake backends propagate unchanged.
+    class InfeasibleSeedError : public std::runtime_error {
+
+    public:
+        using std::runtime_error::runtime_error;
+
+    };
+
+
+    // Builds the region of a bur around its min. volume ellipsoid
+    class InflationBackend {
+
+    public:
+        virtual ~InflationBackend() = default;
+        // Times calculateRegion into the stats of the backend
+        drake::geometry::optimization::HPolyhedron inflate(
+            const robots::Robot& robot,
+            GBur::GeneralizedBur& bur,
+            const drake::geometry::optimization::Hyperellipsoid& ellipsoid
+        );
+        const InflationStats& getStats() const;
+        void resetStats();
+        // When false, GBurIRIS skips the min. volume ellipsoid of the bur and passes an empty ellipsoid to inflate
+        virtual bool needsEllipsoid() const;
+
+    protected:
+        virtual drake::geometry::optimization::HPolyhedron calculateRegion(
+            const robots::Robot& robot,
+            GBur::GeneralizedBur& bur,
+            const drake::geometry::optimization::Hyperellipsoid& ellipsoid
+        ) = 0;
+        // Throws an InfeasibleSeedError if the ellipsoid center is outside the domain or in collision
+        static void checkSeed(
+            const robots::Robot& robot,
+            const drake::geometry::optimization::Hyperellipsoid& ellipsoid,
+            const drake::geometry::optimization::HPolyhedron& domain
+        );
+        // Joint limit box
+        static drake::geometry::optimization::HPolyhedron calculateDomain(const robots::Robot& robot);
+
+    private:
+        InflationStats stats;
+
+    };
+
+
+    struct IrisNpBackendOptions {
+        int iterationLimit{ 1 };
+    };
+
+
+    // IrisInConfigurationSpace through InflatePolytope
+    class IrisNpBackend final : public InflationBackend {
+
+    public:
+        explicit IrisNpBackend(const IrisNpBackendOptions& irisNpBackendOptions = {});
+
+    protected:
+        drake::geometry::optimization::HPolyhedron calculateRegion(
+            const robots::Robot& robot,
+            GBur::GeneralizedBur& bur,
+            const drake::geometry::optimization::Hyperellipsoid& ellipsoid
+        ) override;
+
+    private:
+        const IrisNpBackendOptions irisNpBackendOptions;
+
+    };
+
+
+    struct IrisNp2BackendOptions {
+        drake::planning::IrisNp2Options irisNp2Options{};
+    };
+
+
+    // drake::planning::IrisNp2, which needs the robot to use a SceneGraphCollisionChecker
+    class IrisNp2Backend final : public InflationBackend {
+
+    public:
+        explicit IrisNp2Backend(const IrisNp2BackendOptions& irisNp2BackendOptions = {});
+
+    protected:
+        drake::geometry::optimization::HPolyhedron calculateRegion(
+            const robots::Robot& robot,
+            GBur::GeneralizedBur& bur,
+            const drake::geometry::optimization::Hyperellipsoid& ellipsoid
+        ) override;
+
+    private:
+        const IrisNp2BackendOptions irisNp2BackendOptions;
+
+    };
+
+
+    struct IrisZoBackendOptions {
+        drake::planning::IrisZoOptions irisZoOptions{};
+    };
+
+
+    // Sampling-based drake::planning::IrisZo
+    class IrisZoBackend final : public InflationBackend {
+
+    public:
+        explicit IrisZoBackend(const IrisZoBackendOptions& irisZoBackendOptions = {});
+
+    protected:
+        drake::geometry::optimization::HPolyhedron calculateRegion(
+            const robots::Robot& robot,
+            GBur::GeneralizedBur& bur,
+            const drake::geometry::optimization::Hyperellipsoid& ellipsoid
+        ) override;
+
+    private:
+        const IrisZoBackendOptions irisZoBackendOptions;
+
+    };
+
+
+    struct BurPolytopeBackendOptions {
+        // Fraction of the min. distance to collision of the bur center used for the region
+        double distanceRatio{ 1 };
+    };
+
+
+    // No inflation: the region is the polytope {q : sum_i r_i |q_i - c_i| <= d} of the bur center c, certified
+    // collision-free by the enclosing radii r and the min. distance to collision d at c, within the joint limits.
+    // It has 2^dof facets, so robots with more than maxNumOfDof DOF are rejected with a std::invalid_argument.
+    class BurPolytopeBackend final : public InflationBackend {
+
+    public:
+        static constexpr int maxNumOfDof{ 10 };
+
+        explicit BurPolytopeBackend(const BurPolytopeBackendOptions& burPolytopeBackendOptions = {});
+        bool needsEllipsoid() const override;
+
+    protected:
+        drake::geometry::optimization::HPolyhedron calculateRegion(
+            const robots::Robot& robot,
+            GBur::GeneralizedBur& bur,
+            const drake::geometry::optimization::Hyperellipsoid& ellipsoid
+        ) override;
+
+    private:
+        const BurPolytopeBackendOptions burPolytopeBackendOptions;
+
+    };
+
+
+    inline const InflationStats& InflationBackend::getStats() const {
+        return stats;
+    }
+
+    inline void InflationBackend::resetStats() {
+        stats = InflationStats{};
+    }
+
+    inline bool InflationBackend::needsEllipsoid() const {
+        return true;
+    }
+
+    inline bool BurPolytopeBackend::needsEllipsoid() const {
+        return false;
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <drake/multibody/tree/multibody_tree_indexes.h>
+
+#include <Eigen/Dense>
+
+#include <vector>
+#include <tuple>
+#include <deque>
+
+namespace GBurIRIS::GBur {
+
+    // (robot body, obstacle body, witness point on the robot, witness point on the obstacle, distance)
+    using LinkObstacleDistancePair = std::tuple<
+        drake::multibody::BodyIndex,
+        drake::multibody::BodyIndex,
+        Eigen::Vector3d,
+        Eigen::Vector3d,
+        double
+    >;
+
+
+    // Link-obstacle witness points of earlier signed distance queries. The obstacle planes built from the witness
+    // points separate the (convex) obstacle geometries from any robot configuration, so a bur close to a cached query
+    // can reuse them as long as its robot configuration lies on the robot side of every plane. Lookups scan all
+    // entries, which is cheap next to the distance query they replace and, unlike a grid, does not grow with the DOF.
+    class ObstaclePlaneCache {
+
+    public:
+        struct Entry {
+            Eigen::VectorXd configuration;
+            std::vector<LinkObstacleDistancePair> linkObstacleDistancePairs;
+            double minDistance;
+        };
+
+        ObstaclePlaneCache(double searchRadius, double acceptanceRatio = 0.5, int maxNumOfEntries = 1000);
+        // Once the cache holds maxNumOfEntries entries, the oldest one is dropped
+        void insert(Entry entry);
+        // Entry with the closest configuration within searchRadius of q, or nullptr
+        const Entry* findNearest(const Eigen::Ref<const Eigen::VectorXd>& q) const;
+        double getAcceptanceRatio() const;
+        int getNumOfHits() const;
+        int getNumOfMisses() const;
+        void registerHit();
+        void registerMiss();
+
+    private:
+        const double searchRadius;
+        const double acceptanceRatio;
+        const int maxNumOfEntries;
+        std::deque<Entry> entries;
+        int numOfHits{};
+        int numOfMisses{};
+    };
+
+    inline double ObstaclePlaneCache::getAcceptanceRatio() const {
+        return acceptanceRatio;
+    }
+
+    inline int ObstaclePlaneCache::getNumOfHits() const {
+        return numOfHits;
+    }
+
+    inline int ObstaclePlaneCache::getNumOfMisses() const {
+        return numOfMisses;
+    }
+
+    inline void ObstaclePlaneCache::registerHit() {
+        ++numOfHits;
+    }
+
+    inline void ObstaclePlaneCache::registerMiss() {
+        ++numOfMisses;
+    }
+}
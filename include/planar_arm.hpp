@@ -10,11 +10,37 @@ namespace GBurIRIS::robots {
         PlanarArm(
             const drake::planning::CollisionChecker& collisionChecker,
             const std::vector<std::reference_wrapper<const drake::multibody::RigidBody<double>>>& jointChildAndEndEffectorLinks,
-            const std::vector<double>& linkGeometryCompensation
+            const std::vector<double>& linkGeometryCompensation,
+            KinematicsEngineType kinematicsEngineType = KinematicsEngineType::drake
         );
-        std::vector<Eigen::VectorXd> getLinkPositions(const Eigen::VectorXd& qk) override;
-        std::vector<double> getEnclosingRadii(const Eigen::VectorXd& qk) override;
-        double getMaxDisplacement(const Eigen::VectorXd& q1, const Eigen::VectorXd& q2) override;
+        int getWorkspaceDimension() const override;
+        KinematicsEngineType getKinematicsEngineType() const;
+
+    protected:
+        void calculateLinkPositions(
+            const Eigen::Ref<const Eigen::VectorXd>& q,
+            Eigen::Ref<Eigen::MatrixXd> linkPositions
+        ) const override;
+        std::vector<double> calculateEnclosingRadii(
+            const Eigen::Ref<const Eigen::VectorXd>& qk,
+            const Eigen::Ref<const Eigen::MatrixXd>& linkPositions
+        ) const override;
+
+    private:
+        const KinematicsEngineType kinematicsEngineType;
+        Eigen::Vector2d basePosition;
+        Eigen::Matrix2Xd linkOffsets;
+        Eigen::VectorXd jointAxisSigns;
+        std::vector<int> jointPositionIndices;
     };
 
+
+    inline int PlanarArm::getWorkspaceDimension() const {
+        return 2;
+    }
+
+    inline KinematicsEngineType PlanarArm::getKinematicsEngineType() const {
+        return kinematicsEngineType;
+    }
+
 }
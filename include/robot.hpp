@@ -2,10 +2,19 @@
 
 #include <vector>
 #include <functional>
+#include <memory>
+#include <tuple>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <optional>
 
 #include <drake/systems/framework/context.h>
 #include <drake/planning/collision_checker.h>
 #include <drake/multibody/tree/rigid_body.h>
+#include <drake/multibody/tree/revolute_joint.h>
+#include <drake/multibody/plant/multibody_plant.h>
 
 #include <Eigen/Dense>
 
@@ -13,6 +22,20 @@ namespace GBurIRIS::robots {
 
     enum class LinkGeometryCompensationType { positive, negative };
 
+    enum class KinematicsEngineType { drake, analytic };
+
+    // linkDistance bounds the radius of joint i by the distances between link position i and the distal link
+    // positions; jacobian uses the norms of the joint i columns of the distal link position Jacobians, i.e. the
+    // distances from the joint axis itself, which is never looser.
+    enum class EnclosingRadiiType { linkDistance, jacobian };
+
+    // Concurrency contract: the kinematic queries (getLinkPositions, getLinkPositionsMatrix, getEnclosingRadii,
+    // getMaxDisplacement, evaluateSpineStep) are const and may be called concurrently from any number of threads.
+    // Each calling thread evaluates FK on its own scratch plant context, created on first use and kept for the
+    // lifetime of the robot or until the thread calls releaseScratchPlantContext (worker threads should, before they
+    // exit). getCurrentConfiguration, setConfiguration and getPlantContext go through the collision checker's
+    // implicit context and must not be used concurrently. setEnclosingRadiiType must not be called while kinematic
+    // queries are running.
     class Robot {
 
     public:
@@ -22,9 +45,20 @@ namespace GBurIRIS::robots {
             const std::vector<double>& linkGeometryCompensation
         );
         virtual ~Robot() = default;
-        virtual std::vector<Eigen::VectorXd> getLinkPositions(const Eigen::VectorXd& qk) = 0;
-        virtual std::vector<double> getEnclosingRadii(const Eigen::VectorXd& qk) = 0;
-        virtual double getMaxDisplacement(const Eigen::VectorXd& q1, const Eigen::VectorXd& q2) = 0;
+        std::vector<Eigen::VectorXd> getLinkPositions(const Eigen::Ref<const Eigen::VectorXd>& qk) const;
+        // Column i of the preallocated linkPositions buffer receives the link positions of qs.col(i), stored as a
+        // column-major (number of links x workspace dimension) matrix.
+        void getLinkPositions(const Eigen::MatrixXd& qs, Eigen::MatrixXd& linkPositions) const;
+        Eigen::MatrixXd getLinkPositionsMatrix(const Eigen::Ref<const Eigen::VectorXd>& qk) const;
+        std::vector<double> getEnclosingRadii(const Eigen::Ref<const Eigen::VectorXd>& qk) const;
+        double getMaxDisplacement(const Eigen::Ref<const Eigen::VectorXd>& q1, const Eigen::Ref<const Eigen::VectorXd>& q2) const;
+        // Fused evaluation for a single spine step: returns the max. displacement of qk with respect to the spine
+        // starting point (given by its cached link positions) and the enclosing radii at qk, using a single FK of qk.
+        std::tuple<double, std::vector<double>> evaluateSpineStep(
+            const Eigen::Ref<const Eigen::MatrixXd>& startingPointLinkPositions,
+            const Eigen::Ref<const Eigen::VectorXd>& qk
+        ) const;
+        virtual int getWorkspaceDimension() const = 0;
 
         Eigen::VectorXd getCurrentConfiguration() const;
         void setConfiguration(const Eigen::VectorXd& q);
@@ -32,6 +66,14 @@ namespace GBurIRIS::robots {
         const drake::multibody::MultibodyPlant<double>& getPlant() const;
         const std::reference_wrapper<const drake::systems::Context<double>>& getPlantContext() const;
         const std::vector<double>& getLinkGeometryCompensation() const;
+        int getNumOfLinkPositions() const;
+        EnclosingRadiiType getEnclosingRadiiType() const;
+        void setEnclosingRadiiType(EnclosingRadiiType enclosingRadiiType);
+        // Frees the scratch plant context of the calling thread
+        void releaseScratchPlantContext() const;
+        // Returns the number of the link (segment between link positions i and i + 1) that the body is rigidly
+        // attached to, or std::nullopt if the body does not move with any of the joints.
+        std::optional<int> getLinkNumber(drake::multibody::BodyIndex bodyIndex) const;
 
     protected:
         const std::vector<std::reference_wrapper<const drake::multibody::RigidBody<double>>> jointChildAndEndEffectorLinks;
@@ -39,6 +81,49 @@ namespace GBurIRIS::robots {
         const drake::planning::CollisionChecker& collisionChecker;
         const drake::multibody::MultibodyPlant<double>& plant;
         std::reference_wrapper<const drake::systems::Context<double>> plantContext;
+        std::unordered_map<drake::multibody::BodyIndex, int> bodyLinkNumbers;
+        // Geometry compensation of every link position: the larger compensation of the two links meeting at it.
+        Eigen::VectorXd linkPositionCompensation;
+        EnclosingRadiiType enclosingRadiiType{ EnclosingRadiiType::linkDistance };
+        std::vector<int> jacobianJointPositionIndices;
+        mutable std::shared_mutex scratchPlantContextsMutex;
+        mutable std::unordered_map<std::thread::id, std::unique_ptr<drake::systems::Context<double>>> scratchPlantContexts;
+
+        drake::systems::Context<double>& getScratchPlantContext() const;
+
+        // Writes the position of every joint child and end effector link (one row per link) for the given
+        // configuration. Evaluated on the calling thread's scratch plant context, so the collision checker context
+        // is never touched.
+        virtual void calculateLinkPositions(
+            const Eigen::Ref<const Eigen::VectorXd>& q,
+            Eigen::Ref<Eigen::MatrixXd> linkPositions
+        ) const;
+        virtual std::vector<double> calculateEnclosingRadii(
+            const Eigen::Ref<const Eigen::VectorXd>& qk,
+            const Eigen::Ref<const Eigen::MatrixXd>& linkPositions
+        ) const = 0;
+        std::vector<double> calculateJacobianEnclosingRadii(const Eigen::Ref<const Eigen::VectorXd>& qk) const;
+        // Dispatches to calculateEnclosingRadii or calculateJacobianEnclosingRadii according to enclosingRadiiType.
+        std::vector<double> evaluateEnclosingRadii(
+            const Eigen::Ref<const Eigen::VectorXd>& qk,
+            const Eigen::Ref<const Eigen::MatrixXd>& linkPositions
+        ) const;
+        // Max. over link positions j > linkNumber of the distance to link position linkNumber plus the compensation of
+        // link position j. linkPositions may hold a subset of the workspace coordinates (e.g. a planar projection).
+        double calculateMaxCompensatedDistance(
+            const Eigen::Ref<const Eigen::MatrixXd>& linkPositions,
+            int linkNumber
+        ) const;
+        double calculateMaxDisplacement(
+            const Eigen::Ref<const Eigen::MatrixXd>& linkPositions1,
+            const Eigen::Ref<const Eigen::MatrixXd>& linkPositions2
+        ) const;
+        const drake::multibody::RevoluteJoint<double>& getRevoluteJointWithChild(
+            const drake::multibody::RigidBody<double>& link
+        ) const;
+        // Compares calculateLinkPositions against the plant kinematics on a fixed set of configurations spread over
+        // the joint limits and throws if they disagree. Used to validate analytic kinematics engines.
+        void checkKinematicsConsistency(double tolerance = 1e-9) const;
     };
 
 
@@ -63,8 +148,70 @@ namespace GBurIRIS::robots {
         return plantContext;
     }
 
+    inline std::vector<double> Robot::getEnclosingRadii(const Eigen::Ref<const Eigen::VectorXd>& qk) const {
+        if (enclosingRadiiType == EnclosingRadiiType::jacobian) {
+            return calculateJacobianEnclosingRadii(qk);
+        }
+
+        return calculateEnclosingRadii(qk, getLinkPositionsMatrix(qk));
+    }
+
+    inline double Robot::getMaxDisplacement(
+        const Eigen::Ref<const Eigen::VectorXd>& q1,
+        const Eigen::Ref<const Eigen::VectorXd>& q2
+    ) const {
+        return calculateMaxDisplacement(getLinkPositionsMatrix(q1), getLinkPositionsMatrix(q2));
+    }
+
     inline const std::vector<double>& Robot::getLinkGeometryCompensation() const {
         return linkGeometryCompensation;
     }
 
+    inline int Robot::getNumOfLinkPositions() const {
+        return jointChildAndEndEffectorLinks.size();
+    }
+
+    inline EnclosingRadiiType Robot::getEnclosingRadiiType() const {
+        return enclosingRadiiType;
+    }
+
+    inline std::optional<int> Robot::getLinkNumber(drake::multibody::BodyIndex bodyIndex) const {
+        if (auto it{ bodyLinkNumbers.find(bodyIndex) }; it != bodyLinkNumbers.end()) {
+            return it->second;
+        }
+
+        return std::nullopt;
+    }
+
+
+    // Walks the revolute joints of the model instance in position order and returns their child links followed by
+    // the end effector (the body welded to the last link, within the same model instance, farthest from it).
+    std::vector<std::reference_wrapper<const drake::multibody::RigidBody<double>>> extractJointChildAndEndEffectorLinks(
+        const drake::multibody::MultibodyPlant<double>& plant,
+        drake::multibody::ModelInstanceIndex modelInstance
+    );
+
+    // For every link (segment between consecutive link positions) returns the radius of a sphere-swept
+    // segment that contains the collision geometry of all bodies welded to the link.
+    std::vector<double> calculateLinkGeometryCompensation(
+        const drake::planning::CollisionChecker& collisionChecker,
+        const std::vector<std::reference_wrapper<const drake::multibody::RigidBody<double>>>& jointChildAndEndEffectorLinks
+    );
+
+    template <typename RobotType, typename... Args>
+    std::unique_ptr<RobotType> makeRobot(
+        const drake::planning::CollisionChecker& collisionChecker,
+        drake::multibody::ModelInstanceIndex modelInstance,
+        Args&&... args
+    ) {
+        auto&& jointChildAndEndEffectorLinks{ extractJointChildAndEndEffectorLinks(collisionChecker.plant(), modelInstance) };
+
+        return std::make_unique<RobotType>(
+            collisionChecker,
+            jointChildAndEndEffectorLinks,
+            calculateLinkGeometryCompensation(collisionChecker, jointChildAndEndEffectorLinks),
+            std::forward<Args>(args)...
+        );
+    }
+
 }
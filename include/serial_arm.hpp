@@ -0,0 +1,55 @@
+#pragma once
+
+#include "robot.hpp"
+
+namespace GBurIRIS::robots {
+
+    // Generic serial chain of revolute joints (e.g. the UR3e and iiwa arms). The fixed link transforms, joint axes
+    // and joint pivots are extracted from the plant's joint tree at construction, after which link positions are
+    // evaluated by a chain product of rotations without going through the plant. The enclosing radius of a joint
+    // is bounded by the distance of the link positions distal to it from its axis.
+    class SerialArm final : public Robot {
+
+    public:
+        SerialArm(
+            const drake::planning::CollisionChecker& collisionChecker,
+            const std::vector<std::reference_wrapper<const drake::multibody::RigidBody<double>>>& jointChildAndEndEffectorLinks,
+            const std::vector<double>& linkGeometryCompensation
+        );
+        int getWorkspaceDimension() const override;
+
+    protected:
+        void calculateLinkPositions(
+            const Eigen::Ref<const Eigen::VectorXd>& q,
+            Eigen::Ref<Eigen::MatrixXd> linkPositions
+        ) const override;
+        std::vector<double> calculateEnclosingRadii(
+            const Eigen::Ref<const Eigen::VectorXd>& qk,
+            const Eigen::Ref<const Eigen::MatrixXd>& linkPositions
+        ) const override;
+
+    private:
+        std::vector<Eigen::Matrix3d> fixedLinkRotations;
+        Eigen::Matrix3Xd fixedLinkTranslations;
+        Eigen::Matrix3Xd jointAxes;
+        Eigen::Matrix3Xd jointPivots;
+        Eigen::Vector3d endEffectorOffset;
+        std::vector<int> jointPositionIndices;
+
+        Eigen::Matrix3d calculateJointRotation(int jointNumber, const Eigen::Ref<const Eigen::VectorXd>& q) const;
+    };
+
+
+    inline int SerialArm::getWorkspaceDimension() const {
+        return 3;
+    }
+
+    inline Eigen::Matrix3d SerialArm::calculateJointRotation(
+        int jointNumber,
+        const Eigen::Ref<const Eigen::VectorXd>& q
+    ) const {
+        return fixedLinkRotations.at(jointNumber) *
+            Eigen::AngleAxisd(q(jointPositionIndices.at(jointNumber)), jointAxes.col(jointNumber)).toRotationMatrix();
+    }
+
+}
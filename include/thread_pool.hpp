@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <cstdint>
+
+namespace GBurIRIS {
+
+    // Fixed set of worker threads that stay alive between runs, so that per-thread state (e.g. the robot's scratch
+    // plant contexts) is created once per worker instead of once per run. run must not be called concurrently.
+    class ThreadPool {
+
+    public:
+        // onWorkerExit, if given, is called on every worker thread right before it exits
+        explicit ThreadPool(int numOfWorkers, std::function<void ()> onWorkerExit = {});
+        ~ThreadPool();
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        // Calls task(i, worker) for every i in [0, numOfTasks) on the workers and the calling thread, and returns
+        // once all calls are done, rethrowing the first exception thrown by a task. worker is in
+        // [0, getNumOfWorkers()], the calling thread being getNumOfWorkers().
+        void run(int numOfTasks, const std::function<void (int, int)>& task);
+        int getNumOfWorkers() const;
+
+    private:
+        std::vector<std::thread> workers;
+        const std::function<void ()> onWorkerExit;
+        std::mutex mutex;
+        std::condition_variable workAvailable;
+        std::condition_variable workDone;
+        const std::function<void (int, int)>* task{ nullptr };
+        int numOfTasks{};
+        std::atomic<int> nextTask{};
+        int numOfBusyWorkers{};
+        std::uint64_t generation{};
+        bool stopping{ false };
+        std::exception_ptr taskException;
+
+        void workerLoop(int worker);
+        void runTasks(int worker);
+    };
+
+    inline int ThreadPool::getNumOfWorkers() const {
+        return workers.size();
+    }
+}
@@ -2,82 +2,139 @@
 
 #include <algorithm>
 #include <iostream>
+#include <cmath>
+#include <stdexcept>
 
 
 
 GBurIRIS::robots::AnthropomorphicArm::AnthropomorphicArm(
     const drake::planning::CollisionChecker& collisionChecker,
     const std::vector<std::reference_wrapper<const drake::multibody::RigidBody<double>>>& jointChildAndEndEffectorLinks,
-    const std::vector<double>& linkGeometryCompensation
-) : Robot{collisionChecker, jointChildAndEndEffectorLinks, linkGeometryCompensation} { }
+    const std::vector<double>& linkGeometryCompensation,
+    KinematicsEngineType kinematicsEngineType
+) : Robot{collisionChecker, jointChildAndEndEffectorLinks, linkGeometryCompensation},
+    kinematicsEngineType{ kinematicsEngineType } {
 
+    if (kinematicsEngineType != KinematicsEngineType::analytic) {
+        return;
+    }
 
+    // The arm is a base yaw joint followed by parallel pitch joints. The yaw rotates the whole chain about the
+    // world z-axis, while each pitch rotates the remaining link offsets about the common pitch axis (Rodrigues'
+    // formula with the axis dependent terms precomputed here from the plant in the zero configuration).
+    int numOfJoints{ getNumOfLinkPositions() - 1 };
 
-std::vector<Eigen::VectorXd> GBurIRIS::robots::AnthropomorphicArm::getLinkPositions(const Eigen::VectorXd& qk) {
-    auto&& previousConfig{ getCurrentConfiguration() };
+    if (numOfJoints < 2) {
+        throw std::invalid_argument("Analytic kinematics requires a yaw joint followed by at least one pitch joint!");
+    }
 
-    std::vector<Eigen::VectorXd> linkPositions;
+    linkOffsets.resize(3, numOfJoints - 1);
+    linkOffsetsCrossPitchAxis.resize(3, numOfJoints - 1);
+    linkOffsetsAlongPitchAxis.resize(3, numOfJoints - 1);
+    jointAxisSigns.resize(numOfJoints);
+    jointPositionIndices.resize(numOfJoints);
 
-    setConfiguration(qk);
+    auto&& scratchPlantContext{ getScratchPlantContext() };
+    plant.SetPositions(&scratchPlantContext, Eigen::VectorXd::Zero(plant.num_positions()));
 
-    for (auto&& linkBody : jointChildAndEndEffectorLinks) {
-        linkPositions.push_back(plant.EvalBodyPoseInWorld(plantContext, linkBody).translation());
+    std::vector<Eigen::Vector3d> zeroConfigLinkPositions;
+    for (auto&& link : jointChildAndEndEffectorLinks) {
+        zeroConfigLinkPositions.push_back(plant.EvalBodyPoseInWorld(scratchPlantContext, link.get()).translation());
     }
 
-    setConfiguration(previousConfig);
-
-    return linkPositions;
-}
+    Eigen::Vector3d pitchAxis;
 
+    for (int i{}; i < numOfJoints; ++i) {
+        auto&& joint{ getRevoluteJointWithChild(jointChildAndEndEffectorLinks.at(i)) };
+        Eigen::Vector3d jointAxis{
+            joint.frame_on_child().CalcRotationMatrixInWorld(scratchPlantContext) * joint.revolute_axis()
+        };
 
+        jointPositionIndices.at(i) = joint.position_start();
 
-std::vector<double> GBurIRIS::robots::AnthropomorphicArm::getEnclosingRadii(const Eigen::VectorXd& qk) {
-    auto&& linkPositions{ getLinkPositions(qk) };
+        if (i == 0) {
+            if (std::abs(std::abs(jointAxis(2)) - 1) > 1e-9) {
+                throw std::invalid_argument("Analytic kinematics requires a base joint axis parallel to the world z-axis!");
+            }
 
-    std::vector<double> radii(linkPositions.size() - 1, 0);
+            jointAxisSigns(i) = (jointAxis(2) > 0) ? (1) : (-1);
+            continue;
+        }
 
-    for (int i{ 1 }; i < linkPositions.size(); ++i) {
-        radii.at(0) = std::max(
-            radii.at(0),
-            (linkPositions.at(0)(Eigen::seq(0, 1)) - linkPositions.at(i)(Eigen::seq(0, 1))).norm() +
-                std::max(
-                    linkGeometryCompensation.at(i - 1),
-                    linkGeometryCompensation.at(((i < linkGeometryCompensation.size()) ? (i) : (i - 1)))
-                )
-        );
-    }
+        if (i == 1) {
+            pitchAxis = jointAxis;
+        }
 
-    for (int i{ 1 }; i + 1 < linkPositions.size(); ++i) {
-        for (int j{ i + 1 }; j < linkPositions.size(); ++j) {
-            radii.at(i) = std::max(
-                radii.at(i),
-                (linkPositions.at(i) - linkPositions.at(j)).norm() +
-                    std::max(
-                        linkGeometryCompensation.at(j - 1),
-                        linkGeometryCompensation.at(((j < linkGeometryCompensation.size()) ? (j) : (j - 1)))
-                    )
-            );
+        if (std::abs(std::abs(pitchAxis.dot(jointAxis)) - 1) > 1e-9) {
+            throw std::invalid_argument("Analytic kinematics requires parallel pitch joint axes!");
         }
+
+        jointAxisSigns(i) = (pitchAxis.dot(jointAxis) > 0) ? (1) : (-1);
+
+        Eigen::Vector3d linkOffset{ zeroConfigLinkPositions.at(i + 1) - zeroConfigLinkPositions.at(i) };
+        linkOffsets.col(i - 1) = linkOffset;
+        linkOffsetsCrossPitchAxis.col(i - 1) = pitchAxis.cross(linkOffset);
+        linkOffsetsAlongPitchAxis.col(i - 1) = pitchAxis * pitchAxis.dot(linkOffset);
     }
 
+    basePosition = zeroConfigLinkPositions.at(0);
+    shoulderOffset = zeroConfigLinkPositions.at(1) - zeroConfigLinkPositions.at(0);
 
-    return radii;
+    checkKinematicsConsistency();
 }
 
 
-double GBurIRIS::robots::AnthropomorphicArm::getMaxDisplacement(const Eigen::VectorXd& q1, const Eigen::VectorXd& q2) {
-    auto&& linkPositions1{ getLinkPositions(q1) }, linkPositions2{ getLinkPositions(q2) };
-
-    double maxDisplacement{};
 
-    for (int i{ 1 }; i < linkPositions1.size(); ++i) {
-        maxDisplacement = std::max(
-            maxDisplacement,
-            (linkPositions1.at(i) - linkPositions2.at(i)).norm()
-        );
+void GBurIRIS::robots::AnthropomorphicArm::calculateLinkPositions(
+    const Eigen::Ref<const Eigen::VectorXd>& q,
+    Eigen::Ref<Eigen::MatrixXd> linkPositions
+) const {
+    if (kinematicsEngineType == KinematicsEngineType::drake) {
+        Robot::calculateLinkPositions(q, linkPositions);
+        return;
     }
 
-    return maxDisplacement;
+    double yawAngle{ jointAxisSigns(0) * q(jointPositionIndices.at(0)) };
+    double cosYaw{ std::cos(yawAngle) }, sinYaw{ std::sin(yawAngle) };
+
+    auto rotateAboutYawAxis{
+        [cosYaw, sinYaw](const Eigen::Vector3d& v) -> Eigen::Vector3d {
+            return { cosYaw * v(0) - sinYaw * v(1), sinYaw * v(0) + cosYaw * v(1), v(2) };
+        }
+    };
+
+    linkPositions.row(0) = basePosition.transpose();
+    linkPositions.row(1) = (basePosition + rotateAboutYawAxis(shoulderOffset)).transpose();
+
+    double pitchAngle{};
+
+    for (int i{}; i < linkOffsets.cols(); ++i) {
+        pitchAngle += jointAxisSigns(i + 1) * q(jointPositionIndices.at(i + 1));
+        double cosPitch{ std::cos(pitchAngle) }, sinPitch{ std::sin(pitchAngle) };
+
+        Eigen::Vector3d rotatedLinkOffset{
+            cosPitch * linkOffsets.col(i) + sinPitch * linkOffsetsCrossPitchAxis.col(i) +
+                (1 - cosPitch) * linkOffsetsAlongPitchAxis.col(i)
+        };
+
+        linkPositions.row(i + 2) = linkPositions.row(i + 1) + rotateAboutYawAxis(rotatedLinkOffset).transpose();
+    }
 }
 
 
+
+std::vector<double> GBurIRIS::robots::AnthropomorphicArm::calculateEnclosingRadii(
+    const Eigen::Ref<const Eigen::VectorXd>&,
+    const Eigen::Ref<const Eigen::MatrixXd>& linkPositions
+) const {
+
+    std::vector<double> radii(linkPositions.rows() - 1);
+
+    radii[0] = calculateMaxCompensatedDistance(linkPositions.leftCols(2), 0);
+
+    for (int i{ 1 }; i < radii.size(); ++i) {
+        radii[i] = calculateMaxCompensatedDistance(linkPositions, i);
+    }
+
+    return radii;
+}
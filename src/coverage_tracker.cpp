@@ -0,0 +1,104 @@
+#include "coverage_tracker.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+
+
+GBurIRIS::CoverageTracker::CoverageTracker(
+    const drake::planning::CollisionChecker& collisionChecker,
+    int numOfSamples,
+    const std::function<Eigen::VectorXd ()>& randomConfigGenerator
+) {
+
+    if (numOfSamples <= 0) {
+        throw std::invalid_argument("Number of coverage samples has to be positive!");
+    }
+
+    for (int numSamplesGenerated{}; numSamplesGenerated < numOfSamples;) {
+        if (auto&& q{ randomConfigGenerator() }; collisionChecker.CheckConfigCollisionFree(q)) {
+            if (samples.size() == 0) {
+                samples.resize(q.size(), numOfSamples);
+            }
+
+            samples.col(numSamplesGenerated++) = q;
+        }
+    }
+
+    covered.assign(numOfSamples, false);
+    drawn.assign(numOfSamples, false);
+    regionDistances.setConstant(numOfSamples, std::numeric_limits<double>::infinity());
+    uncoveredSamples.resize(numOfSamples);
+    std::iota(uncoveredSamples.begin(), uncoveredSamples.end(), 0);
+}
+
+
+
+double GBurIRIS::CoverageTracker::addRegion(const drake::geometry::optimization::HPolyhedron& region) {
+    if (uncoveredSamples.empty()) {
+        return getCoverage();
+    }
+
+    // Column i holds the max. normalized constraint violation of uncovered sample i, which is positive exactly when
+    // the sample is outside the region and then bounds its distance to the region from below
+    Eigen::RowVectorXd maxViolations{
+        (
+            ((region.A() * samples(Eigen::all, uncoveredSamples)).colwise() - region.b()).array().colwise() /
+                region.A().rowwise().norm().array()
+        ).colwise().maxCoeff()
+    };
+
+    int numOfUncoveredSamples{};
+    for (int i{}; i < maxViolations.size(); ++i) {
+        if (int sampleNumber{ uncoveredSamples.at(i) }; maxViolations(i) <= 0) {
+            covered.at(sampleNumber) = true;
+        } else {
+            regionDistances(sampleNumber) = std::min(regionDistances(sampleNumber), maxViolations(i));
+            uncoveredSamples.at(numOfUncoveredSamples++) = sampleNumber;
+        }
+    }
+    uncoveredSamples.resize(numOfUncoveredSamples);
+
+    return getCoverage();
+}
+
+
+
+std::optional<int> GBurIRIS::CoverageTracker::drawUncoveredSample(std::mt19937& randomEngine, bool farthestFromRegions) {
+    std::optional<int> sampleNumber;
+
+    if (farthestFromRegions) {
+        for (auto&& candidate : uncoveredSamples) {
+            if (!drawn.at(candidate) && (!sampleNumber || regionDistances(candidate) > regionDistances(*sampleNumber))) {
+                sampleNumber = candidate;
+            }
+        }
+    } else {
+        long numOfCandidates{
+            std::count_if(
+                uncoveredSamples.begin(),
+                uncoveredSamples.end(),
+                [this](int candidate) { return !drawn.at(candidate); }
+            )
+        };
+
+        if (numOfCandidates > 0) {
+            long candidateNumber{ std::uniform_int_distribution<long>(0, numOfCandidates - 1)(randomEngine) };
+
+            for (auto&& candidate : uncoveredSamples) {
+                if (!drawn.at(candidate) && candidateNumber-- == 0) {
+                    sampleNumber = candidate;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (sampleNumber) {
+        drawn.at(*sampleNumber) = true;
+    }
+
+    return sampleNumber;
+}
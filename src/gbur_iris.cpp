@@ -1,53 +1,202 @@
 #include "gbur_iris.hpp"
+#include "inflation_backend.hpp"
 
 #include <drake/geometry/optimization/iris.h>
 #include <drake/geometry/optimization/affine_ball.h>
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <stdexcept>
 #include <string>
 #include <random>
+#include <utility>
 
 
-const char* irisCenterMarginErrorStr{
-    "The current center of the IRIS region is within "
-    "options.configuration_space_margin of being infeasible.  Check your "
-    "sample point and/or any additional constraints you've passed in via "
-    "the options. The configuration space surrounding the sample point "
-    "must have an interior."
-};
+const double minVolumeEllipsoidCrossCheckTolerance{ 1e-2 };
 
 
-drake::geometry::optimization::Hyperellipsoid GBurIRIS::MinVolumeEllipsoid(
-    const drake::planning::CollisionChecker& collisionChecker,
-    const std::vector<Eigen::VectorXd>& points
+GBurIRIS::BurResult::BurResult(
+    Eigen::VectorXd center,
+    Eigen::MatrixXd outerLayer,
+    double minDistanceToCollision
+) : center{ std::move(center) },
+    outerLayer{ std::move(outerLayer) },
+    minDistanceToCollision{ minDistanceToCollision },
+    meanSpineLength{ (this->outerLayer.colwise() - this->center).colwise().norm().mean() } {}
+
+
+drake::geometry::optimization::AffineBall GBurIRIS::KhachiyanMinVolumeEllipsoid(
+    const Eigen::Ref<const Eigen::MatrixXd>& points,
+    double tolerance,
+    int maxIterations,
+    double rankTolerance
 ) {
 
+    const int numOfPoints( points.cols() );
+    Eigen::VectorXd mean{ points.rowwise().mean() };
+    Eigen::MatrixXd centeredPoints{ points.colwise() - mean };
+
+    // Eigenvalues of the scatter matrix are the squared singular values of the centered points, in increasing order
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> scatterEigenSolver(centeredPoints * centeredPoints.transpose());
+    auto&& scatterEigenvalues{ scatterEigenSolver.eigenvalues() };
+    const double rankThreshold{ rankTolerance * rankTolerance * scatterEigenvalues(scatterEigenvalues.size() - 1) };
+
+    int rank{};
+    while (rank < scatterEigenvalues.size() &&
+        scatterEigenvalues(scatterEigenvalues.size() - 1 - rank) > std::max(rankThreshold, 0.)
+    ) {
+        ++rank;
+    }
+
+    if (rank == 0) {
+        return drake::geometry::optimization::AffineBall{ Eigen::MatrixXd::Zero(points.rows(), points.rows()), mean };
+    }
+
+    auto&& basis{ scatterEigenSolver.eigenvectors().rightCols(rank) };
+    Eigen::MatrixXd reducedPoints{ basis.transpose() * centeredPoints };
+
+    // Lifted points (y, 1): the min. volume ellipsoid is the projection of the min. volume central ellipsoid
+    // {x : x^T X(u)^-1 x <= rank + 1} with X(u) = Q diag(u) Q^T and optimal weights u.
+    Eigen::MatrixXd liftedPoints(rank + 1, numOfPoints);
+    liftedPoints.topRows(rank) = reducedPoints;
+    liftedPoints.row(rank).setOnes();
+
+    Eigen::VectorXd weights{ Eigen::VectorXd::Constant(numOfPoints, 1. / numOfPoints) };
+    Eigen::MatrixXd weightedLiftedPoints(rank + 1, numOfPoints);
+    Eigen::MatrixXd solvedLiftedPoints(rank + 1, numOfPoints);
+    Eigen::MatrixXd scatter(rank + 1, rank + 1);
+    Eigen::LLT<Eigen::MatrixXd> scatterLLT(rank + 1);
+    Eigen::VectorXd mahalanobisDistances(numOfPoints);
+    const double liftedDimension( rank + 1 );
+
+    for (int iteration{}; iteration < maxIterations; ++iteration) {
+        weightedLiftedPoints = liftedPoints * weights.asDiagonal();
+        scatter.noalias() = weightedLiftedPoints * liftedPoints.transpose();
+        scatterLLT.compute(scatter);
+
+        solvedLiftedPoints = liftedPoints;
+        scatterLLT.solveInPlace(solvedLiftedPoints);
+        mahalanobisDistances = (liftedPoints.array() * solvedLiftedPoints.array()).colwise().sum().transpose();
+
+        int farthestPoint;
+        const double maxDistance{ mahalanobisDistances.maxCoeff(&farthestPoint) };
+
+        int closestSupportPoint{ -1 };
+        double minDistance{ std::numeric_limits<double>::infinity() };
+        for (int i{}; i < numOfPoints; ++i) {
+            if (weights(i) > 0 && mahalanobisDistances(i) < minDistance) {
+                minDistance = mahalanobisDistances(i);
+                closestSupportPoint = i;
+            }
+        }
+
+        const double increase{ maxDistance - liftedDimension };
+        const double decrease{ liftedDimension - minDistance };
+
+        if (increase <= tolerance * liftedDimension && decrease <= tolerance * liftedDimension) {
+            break;
+        }
 
+        if (increase >= decrease) {
+            const double step{ increase / (liftedDimension * (maxDistance - 1)) };
+            weights *= 1 - step;
+            weights(farthestPoint) += step;
+        } else {
+            // Todd-Yildirim away step: shift weight off the support point closest to the center, dropping it from
+            // the support when the optimal step would make its weight negative
+            const double weight{ weights(closestSupportPoint) };
+            double step{ weight / (1 - weight) };
+            if (minDistance > 1) {
+                step = std::min(step, decrease / (liftedDimension * (minDistance - 1)));
+            }
 
-    Eigen::MatrixXd pointsMatrix(points.begin()->size(), points.size());
-    for (int i{}; i < points.size(); ++i) {
-        pointsMatrix.col(i) = points.at(i);
+            weights *= 1 + step;
+            weights(closestSupportPoint) = std::max(weights(closestSupportPoint) - step, 0.);
+        }
     }
 
-    auto affineBall {
-        drake::geometry::optimization::AffineBall::MinimumVolumeCircumscribedEllipsoid(pointsMatrix)
+    Eigen::VectorXd reducedCenter{ reducedPoints * weights };
+    Eigen::MatrixXd shape{
+        rank * (reducedPoints * weights.asDiagonal() * reducedPoints.transpose() - reducedCenter * reducedCenter.transpose())
     };
 
-//     return drake::geometry::optimization::Hyperellipsoid{ affineBall };
+    // Scale so that the ellipsoid contains every point despite the termination tolerance
+    Eigen::MatrixXd offsets{ reducedPoints.colwise() - reducedCenter };
+    const double maxOffset{ (offsets.array() * shape.llt().solve(offsets).array()).colwise().sum().maxCoeff() };
+    shape *= std::max(maxOffset, 1.);
+
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> shapeEigenSolver(shape);
+
+    return drake::geometry::optimization::AffineBall{
+        basis * shapeEigenSolver.operatorSqrt() * basis.transpose(),
+        mean + basis * reducedCenter
+    };
+}
+
+
+drake::geometry::optimization::Hyperellipsoid GBurIRIS::MinVolumeEllipsoid(
+    const drake::planning::CollisionChecker& collisionChecker,
+    const Eigen::Ref<const Eigen::MatrixXd>& points,
+    MinVolumeEllipsoidSolver minVolumeEllipsoidSolver,
+    bool crossCheck
+) {
+
+    auto solve{
+        [&points](MinVolumeEllipsoidSolver solver) {
+            return solver == MinVolumeEllipsoidSolver::khachiyan ?
+                KhachiyanMinVolumeEllipsoid(points) :
+                drake::geometry::optimization::AffineBall::MinimumVolumeCircumscribedEllipsoid(points);
+        }
+    };
+
+    auto affineBall{ solve(minVolumeEllipsoidSolver) };
 
+    if (crossCheck) {
+        auto&& referenceAffineBall{
+            solve(
+                minVolumeEllipsoidSolver == MinVolumeEllipsoidSolver::khachiyan ?
+                    MinVolumeEllipsoidSolver::drake :
+                    MinVolumeEllipsoidSolver::khachiyan
+            )
+        };
 
-    Eigen::JacobiSVD<Eigen::MatrixXd> svd(affineBall.B(), Eigen::ComputeFullU | Eigen::ComputeFullV);
-    Eigen::MatrixXd U{ svd.matrixU() };
-    Eigen::MatrixXd S{ svd.singularValues().asDiagonal() };
-    Eigen::MatrixXd V{ svd.matrixV() };
+        Eigen::MatrixXd shape{ affineBall.B() * affineBall.B().transpose() };
+        Eigen::MatrixXd referenceShape{ referenceAffineBall.B() * referenceAffineBall.B().transpose() };
+        const double scale{ std::max(referenceShape.norm(), 1e-12) };
 
-    for (int i{}; i < S.size(); ++i) {
-        if (S(i) < 1e-3) {
-            S(i) = 1e-3;
+        if ((shape - referenceShape).norm() > minVolumeEllipsoidCrossCheckTolerance * scale ||
+            (affineBall.center() - referenceAffineBall.center()).norm() >
+                minVolumeEllipsoidCrossCheckTolerance * std::sqrt(scale)
+        ) {
+            throw std::runtime_error("Min. volume ellipsoid solvers disagree!");
         }
     }
 
-    Eigen::MatrixXd newB{ U * S * V.transpose() };
+//     return drake::geometry::optimization::Hyperellipsoid{ affineBall };
+
+
+    Eigen::MatrixXd newB;
+
+    if (minVolumeEllipsoidSolver == MinVolumeEllipsoidSolver::khachiyan) {
+        // B is symmetric positive semidefinite, so its eigenvalues are its singular values
+        Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigenSolver(affineBall.B());
+        newB = eigenSolver.eigenvectors() *
+            eigenSolver.eigenvalues().cwiseMax(1e-3).asDiagonal() *
+            eigenSolver.eigenvectors().transpose();
+    } else {
+        Eigen::JacobiSVD<Eigen::MatrixXd> svd(affineBall.B(), Eigen::ComputeFullU | Eigen::ComputeFullV);
+        Eigen::MatrixXd U{ svd.matrixU() };
+        Eigen::MatrixXd S{ svd.singularValues().asDiagonal() };
+        Eigen::MatrixXd V{ svd.matrixV() };
+
+        for (int i{}; i < S.size(); ++i) {
+            if (S(i) < 1e-3) {
+                S(i) = 1e-3;
+            }
+        }
+
+        newB = U * S * V.transpose();
+    }
 
     if (std::abs(newB.determinant()) < 1e-9) {
         throw std::runtime_error("Points are too close!");
@@ -62,11 +211,11 @@ drake::geometry::optimization::Hyperellipsoid GBurIRIS::MinVolumeEllipsoid(
     }
 
     int closestPoint{};
-    double minDistance{ (points.at(closestPoint) - ellipsoidCenter).norm() };
+    double minDistance{ (points.col(closestPoint) - ellipsoidCenter).norm() };
 
-    for (int i{ 1 }; i < points.size(); ++i) {
-        if (double currentDistance{ (points.at(i) - ellipsoidCenter).norm() }; currentDistance < minDistance &&
-            collisionChecker.CheckConfigCollisionFree(points.at(i))
+    for (int i{ 1 }; i < points.cols(); ++i) {
+        if (double currentDistance{ (points.col(i) - ellipsoidCenter).norm() }; currentDistance < minDistance &&
+            collisionChecker.CheckConfigCollisionFree(points.col(i))
         ) {
             minDistance = currentDistance;
             closestPoint = i;
@@ -74,7 +223,7 @@ drake::geometry::optimization::Hyperellipsoid GBurIRIS::MinVolumeEllipsoid(
     }
 
     return drake::geometry::optimization::Hyperellipsoid{
-        drake::geometry::optimization::AffineBall{ newB, points.at(closestPoint) }
+        drake::geometry::optimization::AffineBall{ newB, points.col(closestPoint) }
     };
 }
 
@@ -119,207 +268,220 @@ double GBurIRIS::CheckCoverage(
     return double(numCoveredPoints) / double(numSamplesCoverageCheck);
 }
 
-std::tuple<
-    std::vector<drake::geometry::optimization::HPolyhedron>,
-    double,
-    std::vector<GBurIRIS::GBur::GeneralizedBur>
-> GBurIRIS::GBurIRIS(
-    robots::Robot& robot,
-    const GBurIRISConfig& gBurIRISConfig,
-    const std::function<Eigen::VectorXd ()>& randomConfigGenerator
-) {
-
-    std::vector<drake::geometry::optimization::HPolyhedron> regions;
-    std::vector<GBur::GeneralizedBur> burs;
-    double coverage;
+namespace {
+
+    // Shared by both GBurIRIS overloads; generateRandomRotationMatrix may be empty
+    std::tuple<
+        std::vector<drake::geometry::optimization::HPolyhedron>,
+        double,
+        std::vector<GBurIRIS::BurResult>,
+        GBurIRIS::InflationStats
+    > runGBurIRIS(
+        GBurIRIS::robots::Robot& robot,
+        const GBurIRIS::GBurIRISConfig& gBurIRISConfig,
+        const std::function<Eigen::VectorXd ()>& randomConfigGenerator,
+        const std::function<Eigen::MatrixXd ()>& generateRandomRotationMatrix
+    ) {
+
+        std::vector<drake::geometry::optimization::HPolyhedron> regions;
+        std::vector<GBurIRIS::BurResult> burs;
+        double coverage;
+
+        auto&& collisionChecker{ robot.getCollisionChecker() };
+
+        std::shared_ptr<GBurIRIS::InflationBackend> inflationBackend{ gBurIRISConfig.inflationBackend };
+        if (!inflationBackend) {
+            inflationBackend = std::make_shared<GBurIRIS::IrisNpBackend>(
+                GBurIRIS::IrisNpBackendOptions{ gBurIRISConfig.numOfIterIRIS }
+            );
+        }
 
-    auto&& collisionChecker{ robot.getCollisionChecker() };
+        // One pool for all burs, so that spine threads and their scratch plant contexts are created once per run
+        std::optional<GBurIRIS::ThreadPool> threadPool;
+        if (gBurIRISConfig.numOfThreads > 1) {
+            threadPool.emplace(
+                std::min(gBurIRISConfig.numOfThreads, gBurIRISConfig.numOfSpines) - 1,
+                [&robot]() { robot.releaseScratchPlantContext(); }
+            );
+        }
 
-    for (int i{}; i < gBurIRISConfig.numOfIter; ++i) {
-        coverage = CheckCoverage(
-            collisionChecker,
-            regions,
-            gBurIRISConfig.numPointsCoverageCheck,
-            randomConfigGenerator
-        );
+        std::optional<GBurIRIS::GBur::ObstaclePlaneCache> obstaclePlaneCache;
+        if (gBurIRISConfig.obstaclePlaneCacheSearchRadius) {
+            obstaclePlaneCache.emplace(
+                *gBurIRISConfig.obstaclePlaneCacheSearchRadius,
+                gBurIRISConfig.obstaclePlaneCacheAcceptanceRatio,
+                gBurIRISConfig.obstaclePlaneCacheMaxNumOfEntries
+            );
+        }
 
+        std::optional<GBurIRIS::CoverageTracker> coverageTracker;
+        if (gBurIRISConfig.incrementalCoverage) {
+            coverageTracker.emplace(collisionChecker, gBurIRISConfig.numPointsCoverageCheck, randomConfigGenerator);
+        }
 
-        if (coverage >= gBurIRISConfig.coverage) {
-            break;
+        // Kept apart from the coverage samples, so that regions are not grown around the samples that measure coverage
+        std::optional<GBurIRIS::CoverageTracker> burCenterPool;
+        if (gBurIRISConfig.burCenterSelection != GBurIRIS::BurCenterSelection::rejectionSampling) {
+            burCenterPool.emplace(collisionChecker, gBurIRISConfig.numOfBurCenterCandidates, randomConfigGenerator);
         }
 
+        std::mt19937 burCenterRandomEngine{ gBurIRISConfig.burCenterSelectionSeed };
 
-        Eigen::VectorXd burCenter;
+        for (int i{}; i < gBurIRISConfig.numOfIter; ++i) {
+            coverage = coverageTracker ?
+                coverageTracker->getCoverage() :
+                GBurIRIS::CheckCoverage(
+                    collisionChecker,
+                    regions,
+                    gBurIRISConfig.numPointsCoverageCheck,
+                    randomConfigGenerator
+                );
+
+
+            if (coverage >= gBurIRISConfig.coverage) {
+                break;
+            }
 
-        for (
-            burCenter = randomConfigGenerator();
-            !collisionChecker.CheckConfigCollisionFree(burCenter) ||
-                std::any_of(
-                    regions.begin(),
-                    regions.end(),
-                    [burCenter](auto&& region) { return region.PointInSet(burCenter); }
+
+            Eigen::VectorXd burCenter;
+
+            if (auto&& sampleNumber{
+                    burCenterPool ?
+                        burCenterPool->drawUncoveredSample(
+                            burCenterRandomEngine,
+                            gBurIRISConfig.burCenterSelection == GBurIRIS::BurCenterSelection::farthestUncoveredSample
+                        ) :
+                        std::nullopt
+                }
+            ) {
+                burCenter = burCenterPool->getSamples().col(*sampleNumber);
+            } else {
+                for (
+                    burCenter = randomConfigGenerator();
+                    !collisionChecker.CheckConfigCollisionFree(burCenter) ||
+                        std::any_of(
+                            regions.begin(),
+                            regions.end(),
+                            [burCenter](auto&& region) { return region.PointInSet(burCenter); }
+                        );
+                    burCenter = randomConfigGenerator()
                 );
-            burCenter = randomConfigGenerator()
-        );
+            }
 
 
-        GBurIRIS::GBur::GeneralizedBur bur(
-            burCenter,
-            GBurIRIS::GBur::GeneralizedBurConfig{
+            GBurIRIS::GBur::GeneralizedBurConfig burConfig{
                 gBurIRISConfig.numOfSpines,
                 gBurIRISConfig.burOrder,
                 gBurIRISConfig.minDistanceTol,
-                gBurIRISConfig.phiTol
-            },
-            robot,
-            randomConfigGenerator
-        );
-
-        if (bur.getMinDistanceToCollision() < gBurIRISConfig.minDistanceTol) {
-            --i;
-            continue;
-        }
+                gBurIRISConfig.phiTol,
+                gBurIRISConfig.obstacleDistanceCutoff,
+                gBurIRISConfig.numOfThreads,
+                gBurIRISConfig.spineStepSolver,
+                gBurIRISConfig.maxSpineStepIterations,
+                gBurIRISConfig.exactDistanceRefreshPeriod,
+                gBurIRISConfig.exactDistanceRefreshRatio
+            };
+
+            // Spine directions come from rotated coordinate axes when a rotation matrix generator is given
+            GBurIRIS::GBur::GeneralizedBur bur{
+                (!generateRandomRotationMatrix) ?
+                    GBurIRIS::GBur::GeneralizedBur(burCenter, burConfig, robot, randomConfigGenerator) :
+                    GBurIRIS::GBur::GeneralizedBur(burCenter, burConfig, robot, generateRandomRotationMatrix())
+            };
+
+            if (obstaclePlaneCache) {
+                bur.setObstaclePlaneCache(*obstaclePlaneCache);
+            }
+
+            if (threadPool) {
+                bur.setThreadPool(*threadPool);
+            }
 
+            if (bur.getMinDistanceToCollision() < gBurIRISConfig.minDistanceTol) {
+                --i;
+                continue;
+            }
 
-        auto [burRandomConfigs, layers] = bur.calculateBur();
 
-        burs.push_back(bur);
+            bur.calculateBur();
 
-        std::vector<Eigen::VectorXd> outerLayer;
-        for (auto&& spine : layers) {
-            outerLayer.push_back(*(spine.end() - 1));
-        }
+            auto&& outerLayer{ bur.getLayer(gBurIRISConfig.burOrder) };
 
-        drake::geometry::optimization::Hyperellipsoid ellipsoid;
-        try {
-            ellipsoid = GBurIRIS::MinVolumeEllipsoid(collisionChecker, outerLayer);
-        } catch (const std::runtime_error& exception) {
-            if (std::string(exception.what()) != "Points are too close!") {
-                throw;
+            drake::geometry::optimization::Hyperellipsoid ellipsoid;
+            if (inflationBackend->needsEllipsoid()) {
+                try {
+                    ellipsoid = GBurIRIS::MinVolumeEllipsoid(
+                        collisionChecker,
+                        outerLayer,
+                        gBurIRISConfig.minVolumeEllipsoidSolver,
+                        gBurIRISConfig.crossCheckMinVolumeEllipsoid
+                    );
+                } catch (const std::runtime_error& exception) {
+                    if (std::string(exception.what()) != "Points are too close!") {
+                        throw;
+                    }
+
+                    --i;
+                    continue;
+                }
             }
 
-            --i;
-            continue;
-        }
+            try {
+                regions.push_back(inflationBackend->inflate(robot, bur, ellipsoid));
+            } catch (const GBurIRIS::InfeasibleSeedError&) {
+                if (!gBurIRISConfig.ignoreDeltaExceptionFromIRISNP) {
+                    throw;
+                }
 
-        try {
-            regions.push_back(GBurIRIS::InflatePolytope(collisionChecker, ellipsoid));
-        } catch (const std::logic_error& exception) {
-            if (!gBurIRISConfig.ignoreDeltaExceptionFromIRISNP ||
-                    std::string(exception.what()) != irisCenterMarginErrorStr
-            ) {
-                throw;
+                --i;
+                continue;
+            }
+
+            if (coverageTracker) {
+                coverageTracker->addRegion(regions.back());
+            }
+
+            if (burCenterPool) {
+                burCenterPool->addRegion(regions.back());
             }
 
-            burs.pop_back();
-            --i;
-            continue;
+            if (gBurIRISConfig.retainBurs) {
+                burs.emplace_back(bur.getCenter(), outerLayer, bur.getMinDistanceToCollision());
+            }
         }
+
+        return std::make_tuple(std::move(regions), coverage, std::move(burs), inflationBackend->getStats());
     }
 
-    return std::make_tuple(regions, coverage, burs);
 }
 
 
 std::tuple<
     std::vector<drake::geometry::optimization::HPolyhedron>,
     double,
-    std::vector<GBurIRIS::GBur::GeneralizedBur>
+    std::vector<GBurIRIS::BurResult>,
+    GBurIRIS::InflationStats
 > GBurIRIS::GBurIRIS(
     robots::Robot& robot,
-    GBurIRISConfig gBurIRISConfig,
-    const std::function<Eigen::VectorXd ()>& randomConfigGenerator,
-    const std::function<Eigen::MatrixXd ()>& generateRandomRotationMatrix
+    const GBurIRISConfig& gBurIRISConfig,
+    const std::function<Eigen::VectorXd ()>& randomConfigGenerator
 ) {
 
-    std::vector<drake::geometry::optimization::HPolyhedron> regions;
-    std::vector<GBur::GeneralizedBur> burs;
-    double coverage;
-
-    auto&& collisionChecker{ robot.getCollisionChecker() };
-
-    for (int i{}; i < gBurIRISConfig.numOfIter; ++i) {
-        coverage = CheckCoverage(
-            collisionChecker,
-            regions,
-            gBurIRISConfig.numPointsCoverageCheck,
-            randomConfigGenerator
-        );
-
-
-        if (coverage >= gBurIRISConfig.coverage) {
-            break;
-        }
-
-
-        Eigen::VectorXd burCenter;
-
-        for (
-            burCenter = randomConfigGenerator();
-            !collisionChecker.CheckConfigCollisionFree(burCenter) ||
-                std::any_of(
-                    regions.begin(),
-                    regions.end(),
-                    [burCenter](auto&& region) { return region.PointInSet(burCenter); }
-                );
-            burCenter = randomConfigGenerator()
-        );
-
-
-        GBurIRIS::GBur::GeneralizedBur bur(
-            burCenter,
-            GBurIRIS::GBur::GeneralizedBurConfig{
-                gBurIRISConfig.numOfSpines,
-                gBurIRISConfig.burOrder,
-                gBurIRISConfig.minDistanceTol,
-                gBurIRISConfig.phiTol
-            },
-            robot,
-            generateRandomRotationMatrix()
-        );
-
-        if (bur.getMinDistanceToCollision() < gBurIRISConfig.minDistanceTol) {
-            --i;
-            continue;
-        }
-
-
-        auto [burRandomConfigs, layers] = bur.calculateBur();
-
-        burs.push_back(bur);
-
-        std::vector<Eigen::VectorXd> outerLayer;
-        for (auto&& spine : layers) {
-            outerLayer.push_back(*(spine.end() - 1));
-        }
-
-        drake::geometry::optimization::Hyperellipsoid ellipsoid;
-        try {
-            ellipsoid = GBurIRIS::MinVolumeEllipsoid(collisionChecker, outerLayer);
-        } catch (const std::runtime_error& exception) {
-            if (std::string(exception.what()) != "Points are too close!") {
-                throw;
-            }
-
-            --i;
-            continue;
-        }
+    return runGBurIRIS(robot, gBurIRISConfig, randomConfigGenerator, nullptr);
+}
 
-        try {
-            regions.push_back(GBurIRIS::InflatePolytope(collisionChecker, ellipsoid));
-        } catch(const std::logic_error& exception) {
-            if (
-                !gBurIRISConfig.ignoreDeltaExceptionFromIRISNP ||
-                std::string(exception.what()) != irisCenterMarginErrorStr
-            ) {
-                throw;
-            }
 
-            burs.pop_back();
-            --i;
-            continue;
-        }
-    }
+std::tuple<
+    std::vector<drake::geometry::optimization::HPolyhedron>,
+    double,
+    std::vector<GBurIRIS::BurResult>,
+    GBurIRIS::InflationStats
+> GBurIRIS::GBurIRIS(
+    robots::Robot& robot,
+    GBurIRISConfig gBurIRISConfig,
+    const std::function<Eigen::VectorXd ()>& randomConfigGenerator,
+    const std::function<Eigen::MatrixXd ()>& generateRandomRotationMatrix
+) {
 
-    return std::make_tuple(regions, coverage, burs);
+    return runGBurIRIS(robot, gBurIRISConfig, randomConfigGenerator, generateRandomRotationMatrix);
 }
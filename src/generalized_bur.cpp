@@ -4,6 +4,55 @@
 #include <numeric>
 #include <cmath>
 #include <stdexcept>
+#include <utility>
+#include <unordered_map>
+#include <cstdint>
+#include <limits>
+
+
+namespace {
+
+    // Largest t in [0, 1] for which q0 + t * (q1 - q0) stays within the joint limits (q0 has to be within them)
+    double calculateJointLimitIntersection(
+        const Eigen::Ref<const Eigen::VectorXd>& q0,
+        const Eigen::Ref<const Eigen::VectorXd>& q1,
+        const Eigen::Ref<const Eigen::VectorXd>& qLowerBounds,
+        const Eigen::Ref<const Eigen::VectorXd>& qUpperBounds
+    ) {
+        double t{ 1 };
+
+        for (int k{}; k < q0.size(); ++k) {
+            if (q1(k) > qUpperBounds(k)) {
+                t = std::min(t, (qUpperBounds(k) - q0(k)) / (q1(k) - q0(k)));
+            } else if (q1(k) < qLowerBounds(k)) {
+                t = std::min(t, (qLowerBounds(k) - q0(k)) / (q1(k) - q0(k)));
+            }
+        }
+
+        return std::max(t, 0.0);
+    }
+
+
+    // Drops the components of the direction from q0 to q1 that point out of the joint limits q0 lies on, so that a
+    // spine stopped by a joint limit continues along it
+    Eigen::VectorXd clipTargetAtJointLimits(
+        const Eigen::Ref<const Eigen::VectorXd>& q0,
+        const Eigen::Ref<const Eigen::VectorXd>& q1,
+        const Eigen::Ref<const Eigen::VectorXd>& qLowerBounds,
+        const Eigen::Ref<const Eigen::VectorXd>& qUpperBounds
+    ) {
+        Eigen::VectorXd clippedTarget{ q1 };
+
+        for (int k{}; k < q0.size(); ++k) {
+            if ((q0(k) >= qUpperBounds(k) && q1(k) > q0(k)) || (q0(k) <= qLowerBounds(k) && q1(k) < q0(k))) {
+                clippedTarget(k) = q0(k);
+            }
+        }
+
+        return clippedTarget;
+    }
+
+}
 
 GBurIRIS::GBur::GeneralizedBur::GeneralizedBur(
     const Eigen::VectorXd& qCenter,
@@ -15,7 +64,7 @@ GBurIRIS::GBur::GeneralizedBur::GeneralizedBur(
     robot{ robot },
     randomConfigGenerator{ randomConfigGenerator } {
 
-    layers.resize(generalizedBurConfig.numOfSpines, std::vector<Eigen::VectorXd>(generalizedBurConfig.burOrder + 1));
+    layers.resize(qCenter.size(), generalizedBurConfig.numOfSpines * (generalizedBurConfig.burOrder + 1));
 }
 
 
@@ -29,7 +78,7 @@ GBurIRIS::GBur::GeneralizedBur::GeneralizedBur(
     robot{ robot },
     rotationMatrix{ rotationMatrix } {
 
-    layers.resize(generalizedBurConfig.numOfSpines, std::vector<Eigen::VectorXd>(generalizedBurConfig.burOrder + 1));
+    layers.resize(qCenter.size(), generalizedBurConfig.numOfSpines * (generalizedBurConfig.burOrder + 1));
 }
 
 
@@ -43,36 +92,75 @@ GBurIRIS::GBur::GeneralizedBur::GeneralizedBur(
     robot{ robot },
     randomConfigs{ randomConfigs } {
 
-    layers.resize(generalizedBurConfig.numOfSpines, std::vector<Eigen::VectorXd>(generalizedBurConfig.burOrder + 1));
+    layers.resize(qCenter.size(), generalizedBurConfig.numOfSpines * (generalizedBurConfig.burOrder + 1));
 }
 
 
 void GBurIRIS::GBur::GeneralizedBur::approximateObstaclesWithPlanes() {
-    if (linkObstacleDistancePairs && linkObstaclePlanes) {
+    if (linkObstacleDistancePairs) {
         return;
     }
 
+    if (obstaclePlaneCache) {
+        if (auto&& entry{ obstaclePlaneCache->findNearest(qCenter) }) {
+            linkObstacleDistancePairs = entry->linkObstacleDistancePairs;
+            obstacleQueryConfiguration = entry->configuration;
+            buildLinkObstaclePlanes();
+
+            if (generalizedBurConfig.obstacleDistanceCutoff) {
+                obstacleQueryEnclosingRadii = robot.getEnclosingRadii(obstacleQueryConfiguration);
+            }
+
+            std::optional<double> certifiedDistance{ calculateCertifiedPlaneDistance(qCenter) };
+
+            if (certifiedDistance && generalizedBurConfig.obstacleDistanceCutoff) {
+                certifiedDistance = std::min(
+                    *certifiedDistance,
+                    *generalizedBurConfig.obstacleDistanceCutoff - calculateMaxGeometryDisplacement(qCenter)
+                );
+            }
+
+            if (certifiedDistance && *certifiedDistance >= obstaclePlaneCache->getAcceptanceRatio() * entry->minDistance) {
+                obstaclePlaneCache->registerHit();
+                minDistance = *certifiedDistance;
+                return;
+            }
+        }
+
+        obstaclePlaneCache->registerMiss();
+    }
+
     linkObstacleDistancePairs = decltype(linkObstacleDistancePairs)::value_type();
-    linkObstaclePlanes =  decltype(linkObstaclePlanes)::value_type();
+    obstacleQueryConfiguration = qCenter;
+
+    if (generalizedBurConfig.obstacleDistanceCutoff) {
+        obstacleQueryEnclosingRadii = robot.getEnclosingRadii(obstacleQueryConfiguration);
+    }
 
     auto&& collisionChecker{ robot.getCollisionChecker() };
     auto&& plant{ robot.getPlant() };
     auto&& plantContext{ collisionChecker.UpdatePositions(qCenter) };
 
     auto&& queryObject{ collisionChecker.model_context().GetQueryObject() };
-    auto&& distancePairs{ queryObject.ComputeSignedDistancePairwiseClosestPoints() };
+    auto&& distancePairs{ queryObject.ComputeSignedDistancePairwiseClosestPoints(
+        generalizedBurConfig.obstacleDistanceCutoff.value_or(std::numeric_limits<double>::infinity())
+    ) };
     auto&& inspector{ queryObject.inspector() };
 
+    // Index into linkObstacleDistancePairs keyed by (robot body, obstacle body)
+    std::unordered_map<std::uint64_t, int> linkObstacleDistancePairIndices;
+
     for (int i{}; i < distancePairs.size(); ++i) {
         auto&& bodyA{ plant.GetBodyFromFrameId(inspector.GetFrameId(distancePairs.at(i).id_A)) };
         auto&& bodyB{ plant.GetBodyFromFrameId(inspector.GetFrameId(distancePairs.at(i).id_B)) };
 
-        if ((collisionChecker.IsPartOfRobot(*bodyA) && collisionChecker.IsPartOfRobot(*bodyB)) ||
-            (!collisionChecker.IsPartOfRobot(*bodyA) && !collisionChecker.IsPartOfRobot(*bodyB))
-        ) {
+        if (!isLinkObstaclePair(*bodyA, *bodyB)) {
             continue;
         }
 
+        // Keep the robot body on side A of every pair
+        bool robotIsBodyA{ collisionChecker.IsPartOfRobot(*bodyA) };
+
         Eigen::Vector4d pointOnAInAFrameHomogCord;
         pointOnAInAFrameHomogCord << distancePairs.at(i).p_ACa, 1;
         Eigen::Vector3d pointOnA{ (bodyA->EvalPoseInWorld(plantContext).GetAsMatrix4() *
@@ -83,40 +171,147 @@ void GBurIRIS::GBur::GeneralizedBur::approximateObstaclesWithPlanes() {
         Eigen::Vector3d pointOnB{ (bodyB->EvalPoseInWorld(plantContext).GetAsMatrix4() *
             (inspector.GetPoseInFrame(distancePairs.at(i).id_B).GetAsMatrix4() * pointOnBInBFrameHomogCord))(Eigen::seq(0, 2)) };
 
-        if (auto it{ std::find_if(
-                linkObstacleDistancePairs->begin(),
-                linkObstacleDistancePairs->end(),
-                [bodyA, bodyB](auto&& linkObstacleDistancePair) -> bool {
-                    return std::get<0>(linkObstacleDistancePair) == bodyA->index() &&
-                        std::get<1>(linkObstacleDistancePair) == bodyB->index();
-                }
-            ) }; it == linkObstacleDistancePairs->end()) {
+        if (!robotIsBodyA) {
+            std::swap(bodyA, bodyB);
+            std::swap(pointOnA, pointOnB);
+        }
+
+        std::uint64_t key{
+            (static_cast<std::uint64_t>(static_cast<int>(bodyA->index())) << 32) |
+                static_cast<std::uint32_t>(static_cast<int>(bodyB->index()))
+        };
 
+        if (auto [it, inserted] = linkObstacleDistancePairIndices.try_emplace(key, linkObstacleDistancePairs->size()); inserted) {
             linkObstacleDistancePairs->emplace_back(bodyA->index(), bodyB->index(), pointOnA, pointOnB, distancePairs.at(i).distance);
-        } else if (std::get<4>(*it) > distancePairs.at(i).distance) {
-            *it = std::make_tuple(bodyA->index(), bodyB->index(), pointOnA, pointOnB, distancePairs.at(i).distance);
+        } else if (auto&& linkObstacleDistancePair{ linkObstacleDistancePairs->at(it->second) };
+            std::get<4>(linkObstacleDistancePair) > distancePairs.at(i).distance
+        ) {
+            linkObstacleDistancePair = std::make_tuple(bodyA->index(), bodyB->index(), pointOnA, pointOnB, distancePairs.at(i).distance);
         }
     }
 
+    buildLinkObstaclePlanes();
+
+    if (obstaclePlaneCache) {
+        obstaclePlaneCache->insert({ qCenter, *linkObstacleDistancePairs, getMinDistanceToCollision() });
+    }
+}
+
+
+
+void GBurIRIS::GBur::GeneralizedBur::buildLinkObstaclePlanes() {
+    int numOfLinks{ robot.getNumOfLinkPositions() - 1 };
+    std::vector<int> numOfLinkObstaclePlanes(numOfLinks, 0);
+
+    for (auto&& linkObstacleDistancePair : *linkObstacleDistancePairs) {
+        ++numOfLinkObstaclePlanes.at(*robot.getLinkNumber(std::get<0>(linkObstacleDistancePair)));
+    }
+
+    linkObstaclePlaneStartRows.assign(numOfLinks + 1, 0);
+    std::partial_sum(numOfLinkObstaclePlanes.begin(), numOfLinkObstaclePlanes.end(), linkObstaclePlaneStartRows.begin() + 1);
+
+    linkObstaclePlaneNormals.resize(linkObstacleDistancePairs->size(), 3);
+    linkObstaclePlaneConstants.resize(linkObstacleDistancePairs->size());
+
+    std::vector<int> nextLinkObstaclePlaneRows(linkObstaclePlaneStartRows.begin(), linkObstaclePlaneStartRows.end() - 1);
+
     for (auto&& linkObstacleDistancePair : *linkObstacleDistancePairs) {
-        Eigen::Vector3d normalVector{ std::get<3>(linkObstacleDistancePair) - std::get<2>(linkObstacleDistancePair) };
-        Eigen::Vector4d obstaclePlane;
-        obstaclePlane << normalVector, -normalVector.dot(std::get<3>(linkObstacleDistancePair));
-        linkObstaclePlanes->push_back(obstaclePlane);
+        int row{ nextLinkObstaclePlaneRows.at(*robot.getLinkNumber(std::get<0>(linkObstacleDistancePair)))++ };
+        Eigen::Vector3d normalVector{ (std::get<3>(linkObstacleDistancePair) - std::get<2>(linkObstacleDistancePair)).normalized() };
+
+        linkObstaclePlaneNormals.row(row) = normalVector.transpose();
+        linkObstaclePlaneConstants(row) = -normalVector.dot(std::get<3>(linkObstacleDistancePair));
+    }
+}
+
+
+bool GBurIRIS::GBur::GeneralizedBur::isLinkObstaclePair(
+    const drake::multibody::RigidBody<double>& bodyA,
+    const drake::multibody::RigidBody<double>& bodyB
+) const {
+
+    auto&& collisionChecker{ robot.getCollisionChecker() };
+
+    if (collisionChecker.IsPartOfRobot(bodyA) == collisionChecker.IsPartOfRobot(bodyB)) {
+        return false;
+    }
+
+    // Bodies that do not move with the joints are not bounded by the enclosing radii
+    return robot.getLinkNumber(((collisionChecker.IsPartOfRobot(bodyA)) ? (bodyA) : (bodyB)).index()).has_value();
+}
+
+
+
+double GBurIRIS::GBur::GeneralizedBur::calculateMinDistanceToCollision(
+    const Eigen::Ref<const Eigen::VectorXd>& q,
+    std::shared_ptr<drake::planning::CollisionCheckerContext>& collisionCheckerContext
+) const {
+
+    auto&& collisionChecker{ robot.getCollisionChecker() };
+    auto&& plant{ robot.getPlant() };
+
+    if (!collisionCheckerContext) {
+        collisionCheckerContext = collisionChecker.MakeStandaloneModelContext();
+    }
+
+    collisionChecker.UpdateContextPositions(collisionCheckerContext.get(), q);
+
+    auto&& queryObject{ collisionCheckerContext->GetQueryObject() };
+    auto&& inspector{ queryObject.inspector() };
+
+    double minDistance{ generalizedBurConfig.obstacleDistanceCutoff.value_or(std::numeric_limits<double>::max()) };
+
+    for (auto&& distancePair : queryObject.ComputeSignedDistancePairwiseClosestPoints(
+        generalizedBurConfig.obstacleDistanceCutoff.value_or(std::numeric_limits<double>::infinity())
+    )) {
+        auto&& bodyA{ plant.GetBodyFromFrameId(inspector.GetFrameId(distancePair.id_A)) };
+        auto&& bodyB{ plant.GetBodyFromFrameId(inspector.GetFrameId(distancePair.id_B)) };
+
+        if (isLinkObstaclePair(*bodyA, *bodyB)) {
+            minDistance = std::min(minDistance, distancePair.distance);
+        }
     }
+
+    return minDistance;
 }
 
 
+
+double GBurIRIS::GBur::GeneralizedBur::calculateLayerMinDistance(
+    const Eigen::Ref<const Eigen::VectorXd>& q,
+    int layerNumber,
+    double previousMinDistance,
+    std::shared_ptr<drake::planning::CollisionCheckerContext>& collisionCheckerContext
+) {
+
+    double minDistance{ getMinDistanceUnderestimation(q) };
+
+    if ((generalizedBurConfig.exactDistanceRefreshPeriod > 0 &&
+            (layerNumber + 1) % generalizedBurConfig.exactDistanceRefreshPeriod == 0) ||
+        minDistance < generalizedBurConfig.exactDistanceRefreshRatio * previousMinDistance
+    ) {
+        minDistance = calculateMinDistanceToCollision(q, collisionCheckerContext);
+    }
+
+    return minDistance;
+}
+
+
+
 double GBurIRIS::GBur::GeneralizedBur::getMinDistanceToCollision() {
     if (minDistance) {
         return *minDistance;
     }
 
-    if (!linkObstacleDistancePairs && !linkObstaclePlanes) {
+    if (!linkObstacleDistancePairs) {
         approximateObstaclesWithPlanes();
+
+        if (minDistance) {
+            return *minDistance;
+        }
     }
 
-    minDistance = std::numeric_limits<double>::max();
+    minDistance = generalizedBurConfig.obstacleDistanceCutoff.value_or(std::numeric_limits<double>::max());
 
     for (auto&& linkObstacleDistancePair : *linkObstacleDistancePairs) {
         minDistance = std::min(*minDistance, std::get<4>(linkObstacleDistancePair));
@@ -127,63 +322,103 @@ double GBurIRIS::GBur::GeneralizedBur::getMinDistanceToCollision() {
 
 
 
-double GBurIRIS::GBur::GeneralizedBur::getMinDistanceUnderestimation(const Eigen::VectorXd& q) {
-    if (!linkObstacleDistancePairs && !linkObstaclePlanes) {
+double GBurIRIS::GBur::GeneralizedBur::getMinDistanceUnderestimation(const Eigen::Ref<const Eigen::VectorXd>& q) {
+    if (!linkObstacleDistancePairs) {
         approximateObstaclesWithPlanes();
     }
 
 
     double minDistance{ std::numeric_limits<double>::max() };
-    int minBodyIndex{ int(std::get<0>(linkObstacleDistancePairs->at(0))) };
 
-    auto&& linkPositions{ robot.getLinkPositions(q) };
-    auto&& linkGeometryCompensation{ robot.getLinkGeometryCompensation() };
+    auto&& linkPositions{ robot.getLinkPositionsMatrix(q) };
+
+    // Only endpoints on the robot side of a plane count, i.e. those with a positive compensated distance
+    for (int i{}; i + 1 < linkObstaclePlaneStartRows.size(); ++i) {
+        int numOfPlanes{ linkObstaclePlaneStartRows[i + 1] - linkObstaclePlaneStartRows[i] };
+        if (numOfPlanes == 0) {
+            continue;
+        }
+
+        Eigen::ArrayXXd endpointDistances{ calculateLinkObstaclePlaneDistances(linkPositions, i) };
 
+        minDistance = std::min(
+            minDistance,
+            (endpointDistances > 0).select(endpointDistances, std::numeric_limits<double>::max()).minCoeff()
+        );
+    }
 
-    for (int i{}; i < linkObstacleDistancePairs->size(); ++i) {
-        auto&& linkObstacleDistancePair{ linkObstacleDistancePairs->at(i) };
-        auto&& linkObstaclePlane{ linkObstaclePlanes->at(i) };
 
-        int linkNumber{ int(std::get<0>(linkObstacleDistancePair)) - minBodyIndex };
+    if (generalizedBurConfig.obstacleDistanceCutoff) {
+        minDistance = std::min(
+            minDistance,
+            *generalizedBurConfig.obstacleDistanceCutoff - calculateMaxGeometryDisplacement(q)
+        );
+    }
 
-        Eigen::VectorXd proximalLinkPoint{ linkPositions.at(linkNumber) }, distalLinkPoint{ linkPositions.at(linkNumber + 1) };
+    if (std::abs(minDistance - std::numeric_limits<double>::max()) < 1e-5) {
+        throw std::runtime_error("Min. distance is infinite (robot may be in collision with a obstacle plane)!");
+    }
 
+    return minDistance;
+}
 
-        Eigen::Vector4d proximalLinkPointInHomogCord, distalLinkPointInHomogCord;
 
-        if (proximalLinkPoint.size() == 2) {
-            proximalLinkPointInHomogCord << proximalLinkPoint, 0, 1;
-            distalLinkPointInHomogCord << distalLinkPoint, 0, 1;
-        } else {
-            proximalLinkPointInHomogCord << proximalLinkPoint, 1;
-            distalLinkPointInHomogCord << distalLinkPoint, 1;
-        }
 
-        double proximalToPlaneHelper{ linkObstaclePlane.dot(proximalLinkPointInHomogCord) },
-            distalToPlaneHelper{ linkObstaclePlane.dot(distalLinkPointInHomogCord) };
+double GBurIRIS::GBur::GeneralizedBur::calculateMaxGeometryDisplacement(const Eigen::Ref<const Eigen::VectorXd>& q) const {
+    double radiiBound{};
+    for (int k{}; k < obstacleQueryEnclosingRadii.size(); ++k) {
+        radiiBound += obstacleQueryEnclosingRadii[k] * std::abs(q(k) - obstacleQueryConfiguration(k));
+    }
 
-        double proximalToPlaneDistance{
-            (std::abs(proximalToPlaneHelper) / linkObstaclePlane(Eigen::seq(0, 2)).norm()) -
-                linkGeometryCompensation.at(linkNumber)
-        };
+    auto&& linkGeometryCompensation{ robot.getLinkGeometryCompensation() };
+    double maxLinkGeometryCompensation{
+        (linkGeometryCompensation.empty()) ?
+            (0) :
+            (*std::max_element(linkGeometryCompensation.begin(), linkGeometryCompensation.end()))
+    };
+
+    return std::min(
+        radiiBound,
+        robot.getMaxDisplacement(obstacleQueryConfiguration, q) + 2 * maxLinkGeometryCompensation
+    );
+}
 
-        double distalToPlaneDistance{
-             std::abs(distalToPlaneHelper) / linkObstaclePlane(Eigen::seq(0, 2)).norm() -
-                linkGeometryCompensation.at(linkNumber)
-        };
 
-        if (proximalToPlaneHelper < 0 && proximalToPlaneDistance > 0 && proximalToPlaneDistance < minDistance) {
-            minDistance = proximalToPlaneDistance;
-        }
 
-        if (distalToPlaneHelper < 0 && distalToPlaneDistance > 0 && distalToPlaneDistance < minDistance) {
-            minDistance = distalToPlaneDistance;
-        }
-    }
+Eigen::ArrayXXd GBurIRIS::GBur::GeneralizedBur::calculateLinkObstaclePlaneDistances(
+    const Eigen::Ref<const Eigen::MatrixXd>& linkPositions,
+    int linkNumber
+) const {
 
+    int numOfPlanes{ linkObstaclePlaneStartRows[linkNumber + 1] - linkObstaclePlaneStartRows[linkNumber] };
 
-    if (std::abs(minDistance - std::numeric_limits<double>::max()) < 1e-5) {
-        throw std::runtime_error("Min. distance is infinite (robot may be in collision with a obstacle plane)!");
+    return (
+        (-linkObstaclePlaneNormals.middleRows(linkObstaclePlaneStartRows[linkNumber], numOfPlanes).leftCols(linkPositions.cols()) *
+            linkPositions.middleRows(linkNumber, 2).transpose()).colwise() -
+        linkObstaclePlaneConstants.segment(linkObstaclePlaneStartRows[linkNumber], numOfPlanes)
+    ).array() - robot.getLinkGeometryCompensation()[linkNumber];
+}
+
+
+
+std::optional<double> GBurIRIS::GBur::GeneralizedBur::calculateCertifiedPlaneDistance(
+    const Eigen::Ref<const Eigen::VectorXd>& q
+) const {
+
+    auto&& linkPositions{ robot.getLinkPositionsMatrix(q) };
+    double minDistance{ std::numeric_limits<double>::max() };
+
+    for (int i{}; i + 1 < linkObstaclePlaneStartRows.size(); ++i) {
+        if (linkObstaclePlaneStartRows[i + 1] == linkObstaclePlaneStartRows[i]) {
+            continue;
+        }
+
+        // The link lies within its geometry compensation of the segment between its endpoints
+        if (double linkMinDistance{ calculateLinkObstaclePlaneDistances(linkPositions, i).minCoeff() }; linkMinDistance > 0) {
+            minDistance = std::min(minDistance, linkMinDistance);
+        } else {
+            return std::nullopt;
+        }
     }
 
     return minDistance;
@@ -191,7 +426,7 @@ double GBurIRIS::GBur::GeneralizedBur::getMinDistanceUnderestimation(const Eigen
 
 
 
-std::tuple<std::vector<Eigen::VectorXd>, std::vector<std::vector<Eigen::VectorXd>>> GBurIRIS::GBur::GeneralizedBur::calculateBur() {
+std::tuple<const std::vector<Eigen::VectorXd>&, const Eigen::MatrixXd&> GBurIRIS::GBur::GeneralizedBur::calculateBur() {
     auto&& qLowerBounds{ robot.getPlant().GetPositionLowerLimits() };
     auto&& qUpperBounds{ robot.getPlant().GetPositionUpperLimits() };
 
@@ -226,47 +461,211 @@ std::tuple<std::vector<Eigen::VectorXd>, std::vector<std::vector<Eigen::VectorXd
         }
     }
 
-    double initMinDistance{ getMinDistanceToCollision() };
+    calculateSpines();
 
-    for (int i{}; i < generalizedBurConfig.numOfSpines; ++i) {
-        auto&& qe{ randomConfigs->at(i) };
-        auto startingPoint{ qCenter };
-        double minDistance{ initMinDistance };
+    return { *randomConfigs, layers };
+}
 
-        for (int j{}; j < generalizedBurConfig.burOrder + 1; ++j) {
-            double tk{};
-            auto qk{ startingPoint };
 
-            while (minDistance > generalizedBurConfig.minDistanceTol &&
-                evaluatePhiFunction(minDistance, tk, qe, startingPoint) >= generalizedBurConfig.phiTol * minDistance) {
 
-                auto&& radii{ robot.getEnclosingRadii(qk) };
+void GBurIRIS::GBur::GeneralizedBur::calculateSpines() {
+    const Eigen::VectorXd qLowerBounds{ robot.getPlant().GetPositionLowerLimits() };
+    const Eigen::VectorXd qUpperBounds{ robot.getPlant().GetPositionUpperLimits() };
 
-                double prevTk{ tk }, weightSum{};
-                auto&& helperVec{ qe - qk };
-                for (int k{}; k < radii.size(); ++k) {
-                    weightSum += radii.at(k) * std::abs(helperVec(k));
-                }
-                tk += (evaluatePhiFunction(minDistance, tk, qe, startingPoint) / weightSum) * (1 - tk);
-                qk = startingPoint + tk * (qe - startingPoint);
+    double initMinDistance{ getMinDistanceToCollision() };
 
-                bool configInsideLimits{ true };
-                for (int k{}; k < qk.size() && configInsideLimits; ++k) {
-                    configInsideLimits = (qk(k) >= qLowerBounds(k)) && (qk(k) <= qUpperBounds(k));
+    // Spines only read the obstacle planes computed above and write to their own layer slots
+    auto&& calculateSpine{
+        [&](int i, std::shared_ptr<drake::planning::CollisionCheckerContext>& collisionCheckerContext) {
+            Eigen::VectorXd qe{ randomConfigs->at(i) };
+            Eigen::VectorXd startingPoint{ qCenter };
+            double minDistance{ initMinDistance };
+
+            for (int j{}; j < generalizedBurConfig.burOrder + 1; ++j) {
+                qe = clipTargetAtJointLimits(startingPoint, qe, qLowerBounds, qUpperBounds);
+
+                if (minDistance > generalizedBurConfig.minDistanceTol) {
+                    startingPoint = (generalizedBurConfig.spineStepSolver == SpineStepSolver::secant) ?
+                        (calculateLayerPointSecant(startingPoint, qe, qLowerBounds, qUpperBounds, minDistance)) :
+                        (calculateLayerPointFixedPoint(startingPoint, qe, qLowerBounds, qUpperBounds, minDistance));
                 }
 
-                if (!configInsideLimits) {
-                    tk = prevTk;
-                    qk = startingPoint + tk * (qe - startingPoint);
-                    break;
+                layers.col(getLayerColumn(i, j)) = startingPoint;
+
+                if (j < generalizedBurConfig.burOrder) {
+                    minDistance = calculateLayerMinDistance(startingPoint, j, minDistance, collisionCheckerContext);
                 }
             }
+        }
+    };
+
+    if (!threadPool && generalizedBurConfig.numOfThreads <= 1) {
+        std::shared_ptr<drake::planning::CollisionCheckerContext> collisionCheckerContext;
+
+        for (int i{}; i < generalizedBurConfig.numOfSpines; ++i) {
+            calculateSpine(i, collisionCheckerContext);
+        }
+
+        return;
+    }
+
+    // Without a pool owned by the caller, the workers of a pool for this bur free their scratch plant contexts
+    // when they exit
+    std::optional<ThreadPool> burThreadPool;
+    if (!threadPool) {
+        burThreadPool.emplace(
+            std::min(generalizedBurConfig.numOfThreads, generalizedBurConfig.numOfSpines) - 1,
+            [this]() { robot.releaseScratchPlantContext(); }
+        );
+    }
+
+    auto&& spineThreadPool{ (threadPool) ? (*threadPool) : (*burThreadPool) };
+    std::vector<std::shared_ptr<drake::planning::CollisionCheckerContext>> collisionCheckerContexts(
+        spineThreadPool.getNumOfWorkers() + 1
+    );
+
+    spineThreadPool.run(
+        generalizedBurConfig.numOfSpines,
+        [&](int i, int worker) { calculateSpine(i, collisionCheckerContexts[worker]); }
+    );
+}
+
+
+
+Eigen::VectorXd GBurIRIS::GBur::GeneralizedBur::calculateLayerPointFixedPoint(
+    const Eigen::Ref<const Eigen::VectorXd>& startingPoint,
+    const Eigen::Ref<const Eigen::VectorXd>& qe,
+    const Eigen::Ref<const Eigen::VectorXd>& qLowerBounds,
+    const Eigen::Ref<const Eigen::VectorXd>& qUpperBounds,
+    double minDistance
+) const {
+
+    double tk{}, limitTk{ calculateJointLimitIntersection(startingPoint, qe, qLowerBounds, qUpperBounds) };
+    Eigen::VectorXd qk{ startingPoint };
+
+    auto&& startingPointLinkPositions{ robot.getLinkPositionsMatrix(startingPoint) };
+
+    for (int iteration{}; iteration < generalizedBurConfig.maxSpineStepIterations && tk < limitTk; ++iteration) {
+        auto [maxDisplacement, radii] = robot.evaluateSpineStep(startingPointLinkPositions, qk);
+
+        double phi{ minDistance - maxDisplacement };
+        if (phi < generalizedBurConfig.phiTol * minDistance) {
+            break;
+        }
+
+        double weightSum{};
+        for (int k{}; k < radii.size(); ++k) {
+            weightSum += radii.at(k) * std::abs(qe(k) - qk(k));
+        }
+        tk = std::min(tk + (phi / weightSum) * (1 - tk), limitTk);
+        qk = (startingPoint + tk * (qe - startingPoint)).cwiseMax(qLowerBounds).cwiseMin(qUpperBounds);
+    }
+
+    return qk;
+}
+
+
+
+Eigen::VectorXd GBurIRIS::GBur::GeneralizedBur::calculateLayerPointSecant(
+    const Eigen::Ref<const Eigen::VectorXd>& startingPoint,
+    const Eigen::Ref<const Eigen::VectorXd>& qe,
+    const Eigen::Ref<const Eigen::VectorXd>& qLowerBounds,
+    const Eigen::Ref<const Eigen::VectorXd>& qUpperBounds,
+    double minDistance
+) const {
+
+    constexpr int maxNumOfBisections{ 3 };
+
+    auto&& startingPointLinkPositions{ robot.getLinkPositionsMatrix(startingPoint) };
+
+    // Bound on the robot displacement per unit of t along the spine
+    auto&& calculateWeightSum{
+        [&startingPoint, &qe](const std::vector<double>& radii) {
+            double weightSum{};
+            for (int k{}; k < radii.size(); ++k) {
+                weightSum += radii[k] * std::abs(qe(k) - startingPoint(k));
+            }
+            return weightSum;
+        }
+    };
+
+    auto&& calculateSpinePoint{
+        [&](double t) -> Eigen::VectorXd {
+            return (startingPoint + t * (qe - startingPoint)).cwiseMax(qLowerBounds).cwiseMin(qUpperBounds);
+        }
+    };
+
+    double tk{}, prevTk{}, prevMaxDisplacement{};
+    double limitTk{ calculateJointLimitIntersection(startingPoint, qe, qLowerBounds, qUpperBounds) };
+    Eigen::VectorXd qk{ startingPoint };
+
+    auto [maxDisplacement, radii] = robot.evaluateSpineStep(startingPointLinkPositions, qk);
+    double weightSum{ calculateWeightSum(radii) };
 
-            layers.at(i).at(j) = qk;
-            startingPoint = qk;
-            minDistance = getMinDistanceUnderestimation(qk);
+    for (int iteration{ 1 }; iteration < generalizedBurConfig.maxSpineStepIterations && tk < limitTk;) {
+        double phi{ minDistance - maxDisplacement };
+        if (phi < generalizedBurConfig.phiTol * minDistance) {
+            break;
         }
+
+        double safeTk{ std::min(limitTk, tk + phi / weightSum) };
+        double candidateTk{ safeTk };
+
+        if (tk > prevTk && maxDisplacement > prevMaxDisplacement) {
+            candidateTk = std::min(limitTk, tk + phi * (tk - prevTk) / (maxDisplacement - prevMaxDisplacement));
+        }
+
+        bool candidateAccepted{ false };
+
+        for (int bisection{};
+            candidateTk > safeTk && bisection < maxNumOfBisections && iteration < generalizedBurConfig.maxSpineStepIterations;
+            ++bisection, candidateTk = (safeTk + candidateTk) / 2
+        ) {
+            Eigen::VectorXd candidate{ calculateSpinePoint(candidateTk) };
+            auto [candidateMaxDisplacement, candidateRadii] = robot.evaluateSpineStep(startingPointLinkPositions, candidate);
+            double candidateWeightSum{ calculateWeightSum(candidateRadii) };
+            ++iteration;
+
+            // Every point between tk and candidateTk is bounded both from tk (forwards) and from candidateTk
+            // (backwards); the larger of the two bounds is at most their value where they cross
+            double maxDisplacementBetween{
+                (maxDisplacement * candidateWeightSum + candidateMaxDisplacement * weightSum +
+                    (candidateTk - tk) * weightSum * candidateWeightSum) / (weightSum + candidateWeightSum)
+            };
+
+            if (maxDisplacementBetween <= minDistance) {
+                prevTk = tk;
+                prevMaxDisplacement = maxDisplacement;
+                tk = candidateTk;
+                qk = candidate;
+                maxDisplacement = candidateMaxDisplacement;
+                weightSum = candidateWeightSum;
+                candidateAccepted = true;
+                break;
+            }
+        }
+
+        if (candidateAccepted) {
+            continue;
+        }
+
+        if (iteration >= generalizedBurConfig.maxSpineStepIterations) {
+            break;
+        }
+
+        prevTk = tk;
+        prevMaxDisplacement = maxDisplacement;
+        tk = safeTk;
+        qk = calculateSpinePoint(tk);
+
+        if (tk >= limitTk) {
+            break;
+        }
+
+        std::tie(maxDisplacement, radii) = robot.evaluateSpineStep(startingPointLinkPositions, qk);
+        weightSum = calculateWeightSum(radii);
+        ++iteration;
     }
 
-    return std::make_tuple(*randomConfigs, layers);
+    return qk;
 }
@@ -0,0 +1,162 @@
+#include "inflation_backend.hpp"
+#include "gbur_iris.hpp"
+
+#include <drake/planning/scene_graph_collision_checker.h>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+
+const char* irisCenterMarginErrorStr{
+    "The current center of the IRIS region is within "
+    "options.configuration_space_margin of being infeasible.  Check your "
+    "sample point and/or any additional constraints you've passed in via "
+    "the options. The configuration space surrounding the sample point "
+    "must have an interior."
+};
+
+
+drake::geometry::optimization::HPolyhedron GBurIRIS::InflationBackend::inflate(
+    const robots::Robot& robot,
+    GBur::GeneralizedBur& bur,
+    const drake::geometry::optimization::Hyperellipsoid& ellipsoid
+) {
+
+    auto startTime{ std::chrono::steady_clock::now() };
+    auto region{ calculateRegion(robot, bur, ellipsoid) };
+    double inflationTime{ std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count() };
+
+    ++stats.numOfInflations;
+    stats.totalTime += inflationTime;
+    stats.maxTime = std::max(stats.maxTime, inflationTime);
+
+    return region;
+}
+
+
+drake::geometry::optimization::HPolyhedron GBurIRIS::InflationBackend::calculateDomain(const robots::Robot& robot) {
+    auto&& plant{ robot.getPlant() };
+
+    return drake::geometry::optimization::HPolyhedron::MakeBox(
+        plant.GetPositionLowerLimits(),
+        plant.GetPositionUpperLimits()
+    );
+}
+
+
+void GBurIRIS::InflationBackend::checkSeed(
+    const robots::Robot& robot,
+    const drake::geometry::optimization::Hyperellipsoid& ellipsoid,
+    const drake::geometry::optimization::HPolyhedron& domain
+) {
+
+    if (!domain.PointInSet(ellipsoid.center())) {
+        throw InfeasibleSeedError("The ellipsoid center is outside the inflation domain!");
+    }
+
+    if (!robot.getCollisionChecker().CheckConfigCollisionFree(ellipsoid.center())) {
+        throw InfeasibleSeedError("The ellipsoid center is in collision!");
+    }
+}
+
+
+GBurIRIS::IrisNpBackend::IrisNpBackend(const IrisNpBackendOptions& irisNpBackendOptions) :
+    irisNpBackendOptions{ irisNpBackendOptions } {}
+
+
+drake::geometry::optimization::HPolyhedron GBurIRIS::IrisNpBackend::calculateRegion(
+    const robots::Robot& robot,
+    GBur::GeneralizedBur&,
+    const drake::geometry::optimization::Hyperellipsoid& ellipsoid
+) {
+
+    checkSeed(robot, ellipsoid, calculateDomain(robot));
+
+    try {
+        return InflatePolytope(robot.getCollisionChecker(), ellipsoid, irisNpBackendOptions.iterationLimit);
+    } catch (const std::logic_error& exception) {
+        if (std::string(exception.what()) != irisCenterMarginErrorStr) {
+            throw;
+        }
+
+        throw InfeasibleSeedError(exception.what());
+    }
+}
+
+
+GBurIRIS::IrisNp2Backend::IrisNp2Backend(const IrisNp2BackendOptions& irisNp2BackendOptions) :
+    irisNp2BackendOptions{ irisNp2BackendOptions } {}
+
+
+drake::geometry::optimization::HPolyhedron GBurIRIS::IrisNp2Backend::calculateRegion(
+    const robots::Robot& robot,
+    GBur::GeneralizedBur&,
+    const drake::geometry::optimization::Hyperellipsoid& ellipsoid
+) {
+
+    auto sceneGraphCollisionChecker{
+        dynamic_cast<const drake::planning::SceneGraphCollisionChecker*>(&robot.getCollisionChecker())
+    };
+
+    if (!sceneGraphCollisionChecker) {
+        throw std::invalid_argument("IrisNp2 needs a SceneGraphCollisionChecker!");
+    }
+
+    auto&& domain{ calculateDomain(robot) };
+    checkSeed(robot, ellipsoid, domain);
+
+    return drake::planning::IrisNp2(*sceneGraphCollisionChecker, ellipsoid, domain, irisNp2BackendOptions.irisNp2Options);
+}
+
+
+GBurIRIS::IrisZoBackend::IrisZoBackend(const IrisZoBackendOptions& irisZoBackendOptions) :
+    irisZoBackendOptions{ irisZoBackendOptions } {}
+
+
+drake::geometry::optimization::HPolyhedron GBurIRIS::IrisZoBackend::calculateRegion(
+    const robots::Robot& robot,
+    GBur::GeneralizedBur&,
+    const drake::geometry::optimization::Hyperellipsoid& ellipsoid
+) {
+
+    auto&& domain{ calculateDomain(robot) };
+    checkSeed(robot, ellipsoid, domain);
+
+    return drake::planning::IrisZo(robot.getCollisionChecker(), ellipsoid, domain, irisZoBackendOptions.irisZoOptions);
+}
+
+
+GBurIRIS::BurPolytopeBackend::BurPolytopeBackend(const BurPolytopeBackendOptions& burPolytopeBackendOptions) :
+    burPolytopeBackendOptions{ burPolytopeBackendOptions } {}
+
+
+drake::geometry::optimization::HPolyhedron GBurIRIS::BurPolytopeBackend::calculateRegion(
+    const robots::Robot& robot,
+    GBur::GeneralizedBur& bur,
+    const drake::geometry::optimization::Hyperellipsoid&
+) {
+
+    Eigen::VectorXd center{ bur.getCenter() };
+    const int numOfDof( center.size() );
+
+    if (numOfDof > maxNumOfDof) {
+        throw std::invalid_argument("The bur polytope backend supports at most " + std::to_string(maxNumOfDof) + " DOF!");
+    }
+
+    auto&& enclosingRadii{ robot.getEnclosingRadii(center) };
+
+    // One facet per orthant: sum_i s_i r_i (q_i - c_i) <= d for every sign vector s
+    Eigen::MatrixXd A(1 << numOfDof, numOfDof);
+    for (int orthant{}; orthant < A.rows(); ++orthant) {
+        for (int i{}; i < numOfDof; ++i) {
+            A(orthant, i) = (orthant >> i & 1 ? -1 : 1) * enclosingRadii.at(i);
+        }
+    }
+
+    Eigen::VectorXd b{
+        (A * center).array() + burPolytopeBackendOptions.distanceRatio * bur.getMinDistanceToCollision()
+    };
+
+    return calculateDomain(robot).Intersection(drake::geometry::optimization::HPolyhedron{ A, b });
+}
@@ -180,13 +180,6 @@ int main() {
 //         plant.GetBodyByName("6dofPlanarEndEffector", plant.GetModelInstanceByName("6dofPlanarArm"))
 //     };
 
-    std::vector<std::reference_wrapper<const drake::multibody::RigidBody<double>>> jointChildAndEndEffectorLinks {
-        plant.GetBodyByName("AnthropomorphicArmLink1", plant.GetModelInstanceByName("AnthropomorphicArm")),
-        plant.GetBodyByName("AnthropomorphicArmLink2", plant.GetModelInstanceByName("AnthropomorphicArm")),
-        plant.GetBodyByName("AnthropomorphicArmLink3", plant.GetModelInstanceByName("AnthropomorphicArm")),
-        plant.GetBodyByName("AnthropomorphicArmEndEffector", plant.GetModelInstanceByName("AnthropomorphicArm"))
-    };
-
 //     std::vector<std::reference_wrapper<const drake::multibody::RigidBody<double>>> jointChildAndEndEffectorLinks {
 //         plant.GetBodyByName("2dofPlanarLink1", plant.GetModelInstanceByName("2dofPlanarArm")),
 //         plant.GetBodyByName("2dofPlanarLink2", plant.GetModelInstanceByName("2dofPlanarArm")),
@@ -195,14 +188,14 @@ int main() {
 
 
 //     std::vector<double> linkGeometryCompensation(6, 0.1);
-    std::vector<double> linkGeometryCompensation(3, 0.1);
 //     std::vector<double> linkGeometryCompensation(2, 0.1);
 
-    GBurIRIS::robots::AnthropomorphicArm anthropomorphicArm(
-        *collisionChecker,
-        jointChildAndEndEffectorLinks,
-        linkGeometryCompensation
-    );
+    std::unique_ptr<GBurIRIS::robots::AnthropomorphicArm> anthropomorphicArm{
+        GBurIRIS::robots::makeRobot<GBurIRIS::robots::AnthropomorphicArm>(
+            *collisionChecker,
+            plant.GetModelInstanceByName("AnthropomorphicArm")
+        )
+    };
 
 //     GBurIRIS::robots::PlanarArm planarArm(*collisionChecker, jointChildAndEndEffectorLinks, linkGeometryCompensation);
 
@@ -215,11 +208,11 @@ int main() {
     gBurIRISConfig.coverage = 0.7;
     gBurIRISConfig.numOfSpines = 6;
 
-    GBurIRIS::testing::TestGBurIRIS testGBurIRIS(anthropomorphicArm, gBurIRISConfig);
+    GBurIRIS::testing::TestGBurIRIS testGBurIRIS(*anthropomorphicArm, gBurIRISConfig);
     auto [execTimeGBurIRIS, numOfRegionsGBurIRIS, coverageGBurIRIS] = testGBurIRIS.run(numOfRuns);
 
     GBurIRIS::testing::TestGBurIRIS testGBurIRIS2(
-        anthropomorphicArm,
+        *anthropomorphicArm,
         gBurIRISConfig,
         GBurIRIS::testing::TestGBurIRIS::GBurDistantConfigOption::rotationMatrix
     );
@@ -234,7 +227,7 @@ int main() {
 
     collisionChecker->SetPaddingAllRobotEnvironmentPairs(irisFromCliqueCoverOptions.iris_options.configuration_space_margin);
 
-    GBurIRIS::testing::TestVCC testVCC(anthropomorphicArm, irisFromCliqueCoverOptions);
+    GBurIRIS::testing::TestVCC testVCC(*anthropomorphicArm, irisFromCliqueCoverOptions);
     auto [execTimeVCC, numOfRegionsVCC, coverageVCC] = testVCC.run(numOfRuns);
 
 
@@ -424,16 +417,10 @@ int main() {
 //
 //     gBur.setRandomConfigs(randomConfigs);
 //
-//     auto [randomConfigs_, layers] = gBur.calculateBur();
-//
-//
-//     std::vector<Eigen::VectorXd> outerLayer;
-//     for (auto&& spine : layers) {
-//         outerLayer.push_back(*(spine.end() - 1));
-//     }
+//     gBur.calculateBur();
 //
 //
-//     auto ellipsoid{ GBurIRIS::MinVolumeEllipsoid(*collisionChecker, outerLayer) };
+//     auto ellipsoid{ GBurIRIS::MinVolumeEllipsoid(*collisionChecker, gBur.getLayer(gBur.getGeneralizedBurConfig().burOrder)) };
 //
 //     auto polytope{ GBurIRIS::InflatePolytope(*collisionChecker, ellipsoid) };
 //
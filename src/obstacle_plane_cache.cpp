@@ -0,0 +1,50 @@
+#include "obstacle_plane_cache.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+
+
+GBurIRIS::GBur::ObstaclePlaneCache::ObstaclePlaneCache(double searchRadius, double acceptanceRatio, int maxNumOfEntries)
+  : searchRadius{ searchRadius },
+    acceptanceRatio{ acceptanceRatio },
+    maxNumOfEntries{ maxNumOfEntries } {
+
+    if (searchRadius <= 0) {
+        throw std::invalid_argument("Search radius has to be positive!");
+    }
+
+    if (maxNumOfEntries <= 0) {
+        throw std::invalid_argument("Max. number of entries has to be positive!");
+    }
+}
+
+
+
+void GBurIRIS::GBur::ObstaclePlaneCache::insert(Entry entry) {
+    if (entries.size() >= maxNumOfEntries) {
+        entries.pop_front();
+    }
+
+    entries.push_back(std::move(entry));
+}
+
+
+
+const GBurIRIS::GBur::ObstaclePlaneCache::Entry* GBurIRIS::GBur::ObstaclePlaneCache::findNearest(
+    const Eigen::Ref<const Eigen::VectorXd>& q
+) const {
+
+    const Entry* nearestEntry{ nullptr };
+    double minSquaredDistance{ searchRadius * searchRadius };
+
+    for (auto&& entry : entries) {
+        if (double squaredDistance{ (entry.configuration - q).squaredNorm() }; squaredDistance <= minSquaredDistance) {
+            minSquaredDistance = squaredDistance;
+            nearestEntry = &entry;
+        }
+    }
+
+    return nearestEntry;
+}
@@ -2,72 +2,96 @@
 
 #include <algorithm>
 #include <iostream>
+#include <cmath>
+#include <stdexcept>
 
 
 
 GBurIRIS::robots::PlanarArm::PlanarArm(
     const drake::planning::CollisionChecker& collisionChecker,
     const std::vector<std::reference_wrapper<const drake::multibody::RigidBody<double>>>& jointChildAndEndEffectorLinks,
-    const std::vector<double>& linkGeometryCompensation
-) : Robot{collisionChecker, jointChildAndEndEffectorLinks, linkGeometryCompensation} { }
+    const std::vector<double>& linkGeometryCompensation,
+    KinematicsEngineType kinematicsEngineType
+) : Robot{collisionChecker, jointChildAndEndEffectorLinks, linkGeometryCompensation},
+    kinematicsEngineType{ kinematicsEngineType } {
 
+    if (kinematicsEngineType != KinematicsEngineType::analytic) {
+        return;
+    }
 
+    // The joint positions of a planar serial chain are a prefix sum of the link offsets rotated by the cumulative
+    // joint angle, so the offsets are extracted once from the plant in the zero configuration.
+    int numOfJoints{ getNumOfLinkPositions() - 1 };
 
-std::vector<Eigen::VectorXd> GBurIRIS::robots::PlanarArm::getLinkPositions(const Eigen::VectorXd& qk) {
-    auto&& previousConfig{ getCurrentConfiguration() };
+    linkOffsets.resize(2, numOfJoints);
+    jointAxisSigns.resize(numOfJoints);
+    jointPositionIndices.resize(numOfJoints);
 
-    std::vector<Eigen::VectorXd> linkPositions;
+    auto&& scratchPlantContext{ getScratchPlantContext() };
+    plant.SetPositions(&scratchPlantContext, Eigen::VectorXd::Zero(plant.num_positions()));
 
-    setConfiguration(qk);
+    for (int i{}; i < numOfJoints; ++i) {
+        auto&& joint{ getRevoluteJointWithChild(jointChildAndEndEffectorLinks.at(i)) };
+        Eigen::Vector3d jointAxis{
+            joint.frame_on_child().CalcRotationMatrixInWorld(scratchPlantContext) * joint.revolute_axis()
+        };
 
-    for (const auto& linkBody : jointChildAndEndEffectorLinks) {
-        linkPositions.push_back(plant.EvalBodyPoseInWorld(plantContext, linkBody).translation()(Eigen::seq(0, 1)));
-    }
+        if (std::abs(std::abs(jointAxis(2)) - 1) > 1e-9) {
+            throw std::invalid_argument("Analytic kinematics requires joint axes parallel to the world z-axis!");
+        }
 
-    setConfiguration(previousConfig);
+        jointAxisSigns(i) = (jointAxis(2) > 0) ? (1) : (-1);
+        jointPositionIndices.at(i) = joint.position_start();
 
-    return linkPositions;
-}
+        linkOffsets.col(i) = (
+            plant.EvalBodyPoseInWorld(scratchPlantContext, jointChildAndEndEffectorLinks.at(i + 1).get()).translation() -
+                plant.EvalBodyPoseInWorld(scratchPlantContext, jointChildAndEndEffectorLinks.at(i).get()).translation()
+        ).head(2);
+    }
 
+    basePosition = plant.EvalBodyPoseInWorld(
+        scratchPlantContext,
+        jointChildAndEndEffectorLinks.at(0).get()
+    ).translation().head(2);
 
+    checkKinematicsConsistency();
+}
 
-std::vector<double> GBurIRIS::robots::PlanarArm::getEnclosingRadii(const Eigen::VectorXd& qk) {
-    auto&& linkPositions{ getLinkPositions(qk) };
 
-    std::vector<double> radii(linkPositions.size() - 1, 0);
 
-    for (int i{}; i + 1 < linkPositions.size(); ++i) {
-        for (int j{ i + 1 }; j < linkPositions.size(); ++j) {
-            radii.at(i) = std::max(
-                radii.at(i),
-                (linkPositions.at(i) - linkPositions.at(j)).norm() +
-                    std::max(
-                        linkGeometryCompensation.at(j - 1),
-                        linkGeometryCompensation.at(((j < linkGeometryCompensation.size()) ? (j) : (j - 1)))
-                    )
-            );
-        }
+void GBurIRIS::robots::PlanarArm::calculateLinkPositions(
+    const Eigen::Ref<const Eigen::VectorXd>& q,
+    Eigen::Ref<Eigen::MatrixXd> linkPositions
+) const {
+    if (kinematicsEngineType == KinematicsEngineType::drake) {
+        Robot::calculateLinkPositions(q, linkPositions);
+        return;
     }
 
+    double angle{};
+    linkPositions.row(0) = basePosition.transpose();
 
-    return radii;
+    for (int i{}; i < linkOffsets.cols(); ++i) {
+        angle += jointAxisSigns(i) * q(jointPositionIndices.at(i));
+        double cosAngle{ std::cos(angle) }, sinAngle{ std::sin(angle) };
+
+        linkPositions(i + 1, 0) = linkPositions(i, 0) + cosAngle * linkOffsets(0, i) - sinAngle * linkOffsets(1, i);
+        linkPositions(i + 1, 1) = linkPositions(i, 1) + sinAngle * linkOffsets(0, i) + cosAngle * linkOffsets(1, i);
+    }
 }
 
 
 
-double GBurIRIS::robots::PlanarArm::getMaxDisplacement(const Eigen::VectorXd& q1, const Eigen::VectorXd& q2) {
-    auto&& linkPositions1{ getLinkPositions(q1) }, linkPositions2{ getLinkPositions(q2) };
+std::vector<double> GBurIRIS::robots::PlanarArm::calculateEnclosingRadii(
+    const Eigen::Ref<const Eigen::VectorXd>&,
+    const Eigen::Ref<const Eigen::MatrixXd>& linkPositions
+) const {
 
-    double maxDisplacement{};
+    std::vector<double> radii(linkPositions.rows() - 1);
 
-    for (int i{ 1 }; i < linkPositions1.size(); ++i) {
-        maxDisplacement = std::max(
-            maxDisplacement,
-            (linkPositions1.at(i) - linkPositions2.at(i)).norm()
-        );
+    for (int i{}; i < radii.size(); ++i) {
+        radii[i] = calculateMaxCompensatedDistance(linkPositions, i);
     }
 
-    return maxDisplacement;
+    return radii;
 }
-
-
@@ -1,6 +1,111 @@
 #include "robot.hpp"
 
+#include <drake/geometry/shape_specification.h>
+
+#include <algorithm>
 #include <stdexcept>
+#include <cmath>
+
+
+namespace {
+
+    double distanceToSegment(const Eigen::Vector3d& point, const Eigen::Vector3d& start, const Eigen::Vector3d& end) {
+        Eigen::Vector3d segment{ end - start };
+        double t{ (segment.squaredNorm() > 0) ? (std::clamp((point - start).dot(segment) / segment.squaredNorm(), 0.0, 1.0)) : (0) };
+
+        return (point - (start + t * segment)).norm();
+    }
+
+
+    // Distance from the segment to the farthest point of the shape. The distance to a segment is convex, so for
+    // polytopes it is attained at a vertex; curved surfaces are replaced by tight circumscribed polytopes.
+    double maxShapeDistanceToSegment(
+        const drake::geometry::Shape& shape,
+        const drake::math::RigidTransformd& X_WG,
+        const Eigen::Vector3d& start,
+        const Eigen::Vector3d& end
+    ) {
+        auto&& distanceToPoint{
+            [&X_WG, &start, &end](const Eigen::Vector3d& pointInGeometryFrame) {
+                return distanceToSegment(X_WG * pointInGeometryFrame, start, end);
+            }
+        };
+
+        // The distance to the segment is convex, so over a convex hull it is largest at one of the hull vertices
+        auto&& maxDistanceToConvexHull{
+            [&distanceToPoint](const drake::geometry::PolygonSurfaceMesh<double>& convexHull) {
+                double maxDistance{};
+                for (int i{}; i < convexHull.num_vertices(); ++i) {
+                    maxDistance = std::max(maxDistance, distanceToPoint(convexHull.vertex(i)));
+                }
+                return maxDistance;
+            }
+        };
+
+        auto&& maxDistanceToBox{
+            [&distanceToPoint](const Eigen::Vector3d& halfSize) {
+                double maxDistance{};
+                for (int i{}; i < 8; ++i) {
+                    maxDistance = std::max(maxDistance, distanceToPoint(Eigen::Vector3d(
+                        ((i & 1) ? (1) : (-1)) * halfSize(0),
+                        ((i & 2) ? (1) : (-1)) * halfSize(1),
+                        ((i & 4) ? (1) : (-1)) * halfSize(2)
+                    )));
+                }
+                return maxDistance;
+            }
+        };
+
+        if (auto sphere{ dynamic_cast<const drake::geometry::Sphere*>(&shape) }) {
+            return distanceToPoint(Eigen::Vector3d::Zero()) + sphere->radius();
+        }
+
+        if (auto capsule{ dynamic_cast<const drake::geometry::Capsule*>(&shape) }) {
+            return std::max(
+                distanceToPoint(Eigen::Vector3d(0, 0, capsule->length() / 2)),
+                distanceToPoint(Eigen::Vector3d(0, 0, -capsule->length() / 2))
+            ) + capsule->radius();
+        }
+
+        if (auto box{ dynamic_cast<const drake::geometry::Box*>(&shape) }) {
+            return maxDistanceToBox(Eigen::Vector3d(box->width(), box->depth(), box->height()) / 2);
+        }
+
+        if (auto ellipsoid{ dynamic_cast<const drake::geometry::Ellipsoid*>(&shape) }) {
+            return maxDistanceToBox(Eigen::Vector3d(ellipsoid->a(), ellipsoid->b(), ellipsoid->c()));
+        }
+
+        if (auto cylinder{ dynamic_cast<const drake::geometry::Cylinder*>(&shape) }) {
+            constexpr int numOfPolygonVertices{ 16 };
+            double circumradius{ cylinder->radius() / std::cos(M_PI / numOfPolygonVertices) };
+
+            double maxDistance{};
+            for (int i{}; i < numOfPolygonVertices; ++i) {
+                double angle{ 2 * M_PI * i / numOfPolygonVertices };
+                for (double z : { -cylinder->length() / 2, cylinder->length() / 2 }) {
+                    maxDistance = std::max(maxDistance, distanceToPoint(Eigen::Vector3d(
+                        circumradius * std::cos(angle),
+                        circumradius * std::sin(angle),
+                        z
+                    )));
+                }
+            }
+            return maxDistance;
+        }
+
+        // Mesh and convex geometries are bounded by their (scaled) convex hulls, which contain them
+        if (auto mesh{ dynamic_cast<const drake::geometry::Mesh*>(&shape) }) {
+            return maxDistanceToConvexHull(mesh->GetConvexHull());
+        }
+
+        if (auto convex{ dynamic_cast<const drake::geometry::Convex*>(&shape) }) {
+            return maxDistanceToConvexHull(convex->GetConvexHull());
+        }
+
+        throw std::invalid_argument("Unsupported collision geometry shape!");
+    }
+
+}
 
 GBurIRIS::robots::Robot::Robot(
     const drake::planning::CollisionChecker& collisionChecker,
@@ -15,4 +120,379 @@ GBurIRIS::robots::Robot::Robot(
     if (jointChildAndEndEffectorLinks.size() != linkGeometryCompensation.size() + 1) {
         throw std::invalid_argument("Invalid vector sizes!");
     }
+
+    for (int i{}; i + 1 < jointChildAndEndEffectorLinks.size(); ++i) {
+        for (auto&& body : plant.GetBodiesWeldedTo(jointChildAndEndEffectorLinks.at(i).get())) {
+            bodyLinkNumbers.emplace(body->index(), i);
+        }
+    }
+
+    linkPositionCompensation.resize(jointChildAndEndEffectorLinks.size());
+    linkPositionCompensation(0) = (linkGeometryCompensation.empty()) ? (0) : (linkGeometryCompensation.front());
+    for (int i{ 1 }; i < linkPositionCompensation.size(); ++i) {
+        linkPositionCompensation(i) = std::max(
+            linkGeometryCompensation.at(i - 1),
+            linkGeometryCompensation.at(((i < linkGeometryCompensation.size()) ? (i) : (i - 1)))
+        );
+    }
+}
+
+
+
+std::vector<Eigen::VectorXd> GBurIRIS::robots::Robot::getLinkPositions(const Eigen::Ref<const Eigen::VectorXd>& qk) const {
+    auto&& linkPositionsMatrix{ getLinkPositionsMatrix(qk) };
+
+    std::vector<Eigen::VectorXd> linkPositions;
+    linkPositions.reserve(linkPositionsMatrix.rows());
+
+    for (int i{}; i < linkPositionsMatrix.rows(); ++i) {
+        linkPositions.push_back(linkPositionsMatrix.row(i).transpose());
+    }
+
+    return linkPositions;
+}
+
+
+
+Eigen::MatrixXd GBurIRIS::robots::Robot::getLinkPositionsMatrix(const Eigen::Ref<const Eigen::VectorXd>& qk) const {
+    Eigen::MatrixXd linkPositions(getNumOfLinkPositions(), getWorkspaceDimension());
+    calculateLinkPositions(qk, linkPositions);
+
+    return linkPositions;
+}
+
+
+
+void GBurIRIS::robots::Robot::getLinkPositions(const Eigen::MatrixXd& qs, Eigen::MatrixXd& linkPositions) const {
+    const int numOfLinkPositions{ getNumOfLinkPositions() }, workspaceDimension{ getWorkspaceDimension() };
+
+    if (linkPositions.rows() != numOfLinkPositions * workspaceDimension || linkPositions.cols() != qs.cols()) {
+        throw std::invalid_argument("Invalid link positions buffer size!");
+    }
+
+    for (int i{}; i < qs.cols(); ++i) {
+        calculateLinkPositions(
+            qs.col(i),
+            Eigen::Map<Eigen::MatrixXd>(linkPositions.col(i).data(), numOfLinkPositions, workspaceDimension)
+        );
+    }
+}
+
+
+
+std::tuple<double, std::vector<double>> GBurIRIS::robots::Robot::evaluateSpineStep(
+    const Eigen::Ref<const Eigen::MatrixXd>& startingPointLinkPositions,
+    const Eigen::Ref<const Eigen::VectorXd>& qk
+) const {
+
+    auto&& linkPositions{ getLinkPositionsMatrix(qk) };
+
+    return std::make_tuple(
+        calculateMaxDisplacement(startingPointLinkPositions, linkPositions),
+        evaluateEnclosingRadii(qk, linkPositions)
+    );
+}
+
+
+
+void GBurIRIS::robots::Robot::setEnclosingRadiiType(EnclosingRadiiType enclosingRadiiType) {
+    if (enclosingRadiiType == EnclosingRadiiType::jacobian && jacobianJointPositionIndices.empty()) {
+        for (int i{}; i + 1 < getNumOfLinkPositions(); ++i) {
+            jacobianJointPositionIndices.push_back(getRevoluteJointWithChild(jointChildAndEndEffectorLinks.at(i)).position_start());
+        }
+    }
+
+    this->enclosingRadiiType = enclosingRadiiType;
+}
+
+
+
+std::vector<double> GBurIRIS::robots::Robot::calculateJacobianEnclosingRadii(const Eigen::Ref<const Eigen::VectorXd>& qk) const {
+    auto&& scratchPlantContext{ getScratchPlantContext() };
+    plant.SetPositions(&scratchPlantContext, qk);
+
+    int numOfLinkPositions{ getNumOfLinkPositions() };
+    int numOfJoints{ numOfLinkPositions - 1 };
+
+    // Column j of the translational Jacobian of a link position is the velocity it gets from joint j, whose norm is
+    // the distance of the link position from the joint j axis (zero for link positions proximal to joint j).
+    Eigen::MatrixXd jointAxisDistances(numOfLinkPositions, numOfJoints);
+    Eigen::MatrixXd jacobian(3, plant.num_positions());
+
+    for (int i{}; i < numOfLinkPositions; ++i) {
+        plant.CalcJacobianTranslationalVelocity(
+            scratchPlantContext,
+            drake::multibody::JacobianWrtVariable::kQDot,
+            jointChildAndEndEffectorLinks.at(i).get().body_frame(),
+            Eigen::Matrix3Xd::Zero(3, 1),
+            plant.world_frame(),
+            plant.world_frame(),
+            &jacobian
+        );
+
+        for (int j{}; j < numOfJoints; ++j) {
+            jointAxisDistances(i, j) = jacobian.col(jacobianJointPositionIndices[j]).norm();
+        }
+    }
+
+    std::vector<double> radii(numOfJoints);
+
+    for (int j{}; j < numOfJoints; ++j) {
+        int numOfDistalLinkPositions{ numOfLinkPositions - j - 1 };
+
+        radii[j] = std::max(
+            jointAxisDistances(j, j) + linkGeometryCompensation[j],
+            (jointAxisDistances.col(j).tail(numOfDistalLinkPositions) + linkPositionCompensation.tail(numOfDistalLinkPositions)).maxCoeff()
+        );
+    }
+
+    return radii;
+}
+
+
+
+std::vector<double> GBurIRIS::robots::Robot::evaluateEnclosingRadii(
+    const Eigen::Ref<const Eigen::VectorXd>& qk,
+    const Eigen::Ref<const Eigen::MatrixXd>& linkPositions
+) const {
+
+    if (enclosingRadiiType == EnclosingRadiiType::jacobian) {
+        return calculateJacobianEnclosingRadii(qk);
+    }
+
+    return calculateEnclosingRadii(qk, linkPositions);
+}
+
+
+
+double GBurIRIS::robots::Robot::calculateMaxCompensatedDistance(
+    const Eigen::Ref<const Eigen::MatrixXd>& linkPositions,
+    int linkNumber
+) const {
+
+    int numOfDistalLinkPositions{ static_cast<int>(linkPositions.rows()) - linkNumber - 1 };
+
+    return (
+        (linkPositions.bottomRows(numOfDistalLinkPositions).rowwise() - linkPositions.row(linkNumber)).rowwise().norm() +
+        linkPositionCompensation.tail(numOfDistalLinkPositions)
+    ).maxCoeff();
+}
+
+
+
+double GBurIRIS::robots::Robot::calculateMaxDisplacement(
+    const Eigen::Ref<const Eigen::MatrixXd>& linkPositions1,
+    const Eigen::Ref<const Eigen::MatrixXd>& linkPositions2
+) const {
+
+    return (linkPositions1 - linkPositions2).bottomRows(linkPositions1.rows() - 1).rowwise().norm().maxCoeff();
+}
+
+
+
+void GBurIRIS::robots::Robot::calculateLinkPositions(
+    const Eigen::Ref<const Eigen::VectorXd>& q,
+    Eigen::Ref<Eigen::MatrixXd> linkPositions
+) const {
+    auto&& scratchPlantContext{ getScratchPlantContext() };
+    plant.SetPositions(&scratchPlantContext, q);
+
+    for (int i{}; i < jointChildAndEndEffectorLinks.size(); ++i) {
+        linkPositions.row(i) = plant.EvalBodyPoseInWorld(
+            scratchPlantContext,
+            jointChildAndEndEffectorLinks.at(i).get()
+        ).translation().head(linkPositions.cols()).transpose();
+    }
+}
+
+
+
+drake::systems::Context<double>& GBurIRIS::robots::Robot::getScratchPlantContext() const {
+    auto threadId{ std::this_thread::get_id() };
+
+    {
+        std::shared_lock lock{ scratchPlantContextsMutex };
+        if (auto it{ scratchPlantContexts.find(threadId) }; it != scratchPlantContexts.end()) {
+            return *it->second;
+        }
+    }
+
+    std::unique_lock lock{ scratchPlantContextsMutex };
+    auto&& scratchPlantContext{ scratchPlantContexts[threadId] };
+    if (!scratchPlantContext) {
+        scratchPlantContext = plant.CreateDefaultContext();
+    }
+
+    return *scratchPlantContext;
+}
+
+
+
+void GBurIRIS::robots::Robot::releaseScratchPlantContext() const {
+    std::unique_lock lock{ scratchPlantContextsMutex };
+    scratchPlantContexts.erase(std::this_thread::get_id());
+}
+
+
+
+const drake::multibody::RevoluteJoint<double>& GBurIRIS::robots::Robot::getRevoluteJointWithChild(
+    const drake::multibody::RigidBody<double>& link
+) const {
+
+    for (auto&& jointIndex : plant.GetJointIndices(link.model_instance())) {
+        if (auto&& joint{ plant.get_joint(jointIndex) }; joint.child_body().index() == link.index()) {
+            if (auto revoluteJoint{ dynamic_cast<const drake::multibody::RevoluteJoint<double>*>(&joint) }) {
+                return *revoluteJoint;
+            }
+
+            throw std::invalid_argument("Link is not the child of a revolute joint!");
+        }
+    }
+
+    throw std::invalid_argument("Link is not the child of any joint!");
+}
+
+
+
+void GBurIRIS::robots::Robot::checkKinematicsConsistency(double tolerance) const {
+    Eigen::VectorXd qLowerBounds{ plant.GetPositionLowerLimits().cwiseMax(-M_PI) };
+    Eigen::VectorXd qUpperBounds{ plant.GetPositionUpperLimits().cwiseMin(M_PI) };
+
+    std::vector<Eigen::VectorXd> configs{
+        Eigen::VectorXd::Zero(qLowerBounds.size()),
+        qLowerBounds,
+        qUpperBounds
+    };
+
+    for (int i{ 1 }; i <= 5; ++i) {
+        Eigen::VectorXd q(qLowerBounds.size());
+        for (int j{}; j < q.size(); ++j) {
+            double fraction{ std::fmod(0.618034 * i * (j + 1), 1.0) };
+            q(j) = qLowerBounds(j) + fraction * (qUpperBounds(j) - qLowerBounds(j));
+        }
+        configs.push_back(q);
+    }
+
+    Eigen::MatrixXd linkPositions(getNumOfLinkPositions(), getWorkspaceDimension());
+    Eigen::MatrixXd plantLinkPositions(getNumOfLinkPositions(), getWorkspaceDimension());
+
+    for (auto&& q : configs) {
+        calculateLinkPositions(q, linkPositions);
+        Robot::calculateLinkPositions(q, plantLinkPositions);
+
+        if ((linkPositions - plantLinkPositions).cwiseAbs().maxCoeff() > tolerance) {
+            throw std::runtime_error("Link positions do not match the plant kinematics!");
+        }
+    }
 }
+
+
+
+std::vector<std::reference_wrapper<const drake::multibody::RigidBody<double>>>
+GBurIRIS::robots::extractJointChildAndEndEffectorLinks(
+    const drake::multibody::MultibodyPlant<double>& plant,
+    drake::multibody::ModelInstanceIndex modelInstance
+) {
+
+    std::vector<const drake::multibody::RevoluteJoint<double>*> revoluteJoints;
+
+    for (auto&& jointIndex : plant.GetJointIndices(modelInstance)) {
+        if (auto revoluteJoint{ dynamic_cast<const drake::multibody::RevoluteJoint<double>*>(&plant.get_joint(jointIndex)) }) {
+            revoluteJoints.push_back(revoluteJoint);
+        }
+    }
+
+    if (revoluteJoints.empty()) {
+        throw std::invalid_argument("Model instance has no revolute joints!");
+    }
+
+    std::sort(
+        revoluteJoints.begin(),
+        revoluteJoints.end(),
+        [](auto&& joint1, auto&& joint2) { return joint1->position_start() < joint2->position_start(); }
+    );
+
+    std::vector<std::reference_wrapper<const drake::multibody::RigidBody<double>>> jointChildAndEndEffectorLinks;
+
+    for (int i{}; i < revoluteJoints.size(); ++i) {
+        if (i > 0) {
+            auto&& previousLinkBodies{ plant.GetBodiesWeldedTo(revoluteJoints.at(i - 1)->child_body()) };
+
+            if (std::none_of(
+                    previousLinkBodies.begin(),
+                    previousLinkBodies.end(),
+                    [&parent = revoluteJoints.at(i)->parent_body()](auto&& body) { return body->index() == parent.index(); }
+                )) {
+                throw std::invalid_argument("Revolute joints of the model instance do not form a serial chain!");
+            }
+        }
+
+        jointChildAndEndEffectorLinks.push_back(revoluteJoints.at(i)->child_body());
+    }
+
+    auto&& plantContext{ plant.CreateDefaultContext() };
+    auto&& lastLink{ revoluteJoints.back()->child_body() };
+    Eigen::Vector3d lastLinkPosition{ plant.EvalBodyPoseInWorld(*plantContext, lastLink).translation() };
+
+    const drake::multibody::RigidBody<double>* endEffector{ &lastLink };
+    double maxEndEffectorDistance{};
+
+    for (auto&& body : plant.GetBodiesWeldedTo(lastLink)) {
+        if (body->model_instance() != modelInstance) {
+            continue;
+        }
+
+        if (double distance{ (plant.EvalBodyPoseInWorld(*plantContext, *body).translation() - lastLinkPosition).norm() };
+            distance > maxEndEffectorDistance
+        ) {
+            maxEndEffectorDistance = distance;
+            endEffector = body;
+        }
+    }
+
+    jointChildAndEndEffectorLinks.push_back(*endEffector);
+
+    return jointChildAndEndEffectorLinks;
+}
+
+
+
+std::vector<double> GBurIRIS::robots::calculateLinkGeometryCompensation(
+    const drake::planning::CollisionChecker& collisionChecker,
+    const std::vector<std::reference_wrapper<const drake::multibody::RigidBody<double>>>& jointChildAndEndEffectorLinks
+) {
+
+    auto&& plant{ collisionChecker.plant() };
+    auto&& plantContext{ plant.CreateDefaultContext() };
+    auto&& inspector{ collisionChecker.model_context().GetQueryObject().inspector() };
+
+    std::vector<double> linkGeometryCompensation(jointChildAndEndEffectorLinks.size() - 1, 0);
+
+    for (int i{}; i < linkGeometryCompensation.size(); ++i) {
+        Eigen::Vector3d linkStart{
+            plant.EvalBodyPoseInWorld(*plantContext, jointChildAndEndEffectorLinks.at(i).get()).translation()
+        };
+        Eigen::Vector3d linkEnd{
+            plant.EvalBodyPoseInWorld(*plantContext, jointChildAndEndEffectorLinks.at(i + 1).get()).translation()
+        };
+
+        for (auto&& body : plant.GetBodiesWeldedTo(jointChildAndEndEffectorLinks.at(i).get())) {
+            auto&& X_WB{ plant.EvalBodyPoseInWorld(*plantContext, *body) };
+
+            for (auto&& geometryId : plant.GetCollisionGeometriesForBody(*body)) {
+                linkGeometryCompensation.at(i) = std::max(
+                    linkGeometryCompensation.at(i),
+                    maxShapeDistanceToSegment(
+                        inspector.GetShape(geometryId),
+                        X_WB * inspector.GetPoseInFrame(geometryId),
+                        linkStart,
+                        linkEnd
+                    )
+                );
+            }
+        }
+    }
+
+    return linkGeometryCompensation;
+}
+
@@ -0,0 +1,104 @@
+#include "serial_arm.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+
+
+GBurIRIS::robots::SerialArm::SerialArm(
+    const drake::planning::CollisionChecker& collisionChecker,
+    const std::vector<std::reference_wrapper<const drake::multibody::RigidBody<double>>>& jointChildAndEndEffectorLinks,
+    const std::vector<double>& linkGeometryCompensation
+) : Robot{collisionChecker, jointChildAndEndEffectorLinks, linkGeometryCompensation} {
+
+    // In the zero configuration every joint transform is the identity, so the pose of link i relative to link i - 1
+    // is the fixed part of the chain. A joint then rotates its child about the joint axis through the joint pivot,
+    // both expressed in the child link frame.
+    int numOfJoints{ getNumOfLinkPositions() - 1 };
+
+    fixedLinkRotations.resize(numOfJoints);
+    fixedLinkTranslations.resize(3, numOfJoints);
+    jointAxes.resize(3, numOfJoints);
+    jointPivots.resize(3, numOfJoints);
+    jointPositionIndices.resize(numOfJoints);
+
+    auto&& scratchPlantContext{ getScratchPlantContext() };
+    plant.SetPositions(&scratchPlantContext, Eigen::VectorXd::Zero(plant.num_positions()));
+
+    Eigen::Matrix3d parentRotation{ Eigen::Matrix3d::Identity() };
+    Eigen::Vector3d parentTranslation{ Eigen::Vector3d::Zero() };
+
+    for (int i{}; i < numOfJoints; ++i) {
+        auto&& joint{ getRevoluteJointWithChild(jointChildAndEndEffectorLinks.at(i)) };
+        auto&& jointFramePose{ joint.frame_on_child().GetFixedPoseInBodyFrame() };
+        auto&& linkPose{ plant.EvalBodyPoseInWorld(scratchPlantContext, jointChildAndEndEffectorLinks.at(i).get()) };
+
+        fixedLinkRotations.at(i) = parentRotation.transpose() * linkPose.rotation().matrix();
+        fixedLinkTranslations.col(i) = parentRotation.transpose() * (linkPose.translation() - parentTranslation);
+        jointAxes.col(i) = (jointFramePose.rotation() * joint.revolute_axis()).normalized();
+        jointPivots.col(i) = jointFramePose.translation();
+        jointPositionIndices.at(i) = joint.position_start();
+
+        parentRotation = linkPose.rotation().matrix();
+        parentTranslation = linkPose.translation();
+    }
+
+    endEffectorOffset = parentRotation.transpose() * (
+        plant.EvalBodyPoseInWorld(scratchPlantContext, jointChildAndEndEffectorLinks.back().get()).translation() -
+            parentTranslation
+    );
+
+    checkKinematicsConsistency();
+}
+
+
+
+void GBurIRIS::robots::SerialArm::calculateLinkPositions(
+    const Eigen::Ref<const Eigen::VectorXd>& q,
+    Eigen::Ref<Eigen::MatrixXd> linkPositions
+) const {
+
+    Eigen::Matrix3d rotation{ Eigen::Matrix3d::Identity() };
+    Eigen::Vector3d position{ Eigen::Vector3d::Zero() };
+
+    for (int i{}; i < jointAxes.cols(); ++i) {
+        Eigen::Matrix3d jointRotation{ calculateJointRotation(i, q) };
+
+        position += rotation * (
+            fixedLinkTranslations.col(i) + fixedLinkRotations.at(i) * jointPivots.col(i) - jointRotation * jointPivots.col(i)
+        );
+        rotation *= jointRotation;
+
+        linkPositions.row(i) = position.transpose();
+    }
+
+    linkPositions.row(jointAxes.cols()) = (position + rotation * endEffectorOffset).transpose();
+}
+
+
+
+std::vector<double> GBurIRIS::robots::SerialArm::calculateEnclosingRadii(
+    const Eigen::Ref<const Eigen::VectorXd>& qk,
+    const Eigen::Ref<const Eigen::MatrixXd>& linkPositions
+) const {
+
+    std::vector<double> radii(linkPositions.rows() - 1);
+    Eigen::Matrix3d rotation{ Eigen::Matrix3d::Identity() };
+
+    for (int i{}; i + 1 < linkPositions.rows(); ++i) {
+        rotation *= calculateJointRotation(i, qk);
+
+        Eigen::Vector3d jointAxis{ rotation * jointAxes.col(i) };
+        Eigen::Vector3d jointPivot{ linkPositions.row(i).transpose() + rotation * jointPivots.col(i) };
+
+        Eigen::MatrixX3d pivotToLinks{ linkPositions.bottomRows(linkPositions.rows() - i).rowwise() - jointPivot.transpose() };
+        Eigen::VectorXd distancesFromAxis{ (pivotToLinks - (pivotToLinks * jointAxis) * jointAxis.transpose()).rowwise().norm() };
+
+        radii[i] = std::max(
+            distancesFromAxis(0) + linkGeometryCompensation[i],
+            (distancesFromAxis.tail(distancesFromAxis.size() - 1) + linkPositionCompensation.tail(distancesFromAxis.size() - 1)).maxCoeff()
+        );
+    }
+
+    return radii;
+}
@@ -111,7 +111,7 @@ std::tuple<
             RandomGenerator randomGenerator(domain, drakeRandomGenerator);
 
             auto startTime{ std::chrono::steady_clock::now() };
-            auto [regionsGBurIRIS, coverageGBurIRIS, burs] = GBurIRIS::GBurIRIS(
+            auto [regionsGBurIRIS, coverageGBurIRIS, burs, inflationStats] = GBurIRIS::GBurIRIS(
                 robot,
                 gBurIRISConfig,
                 std::bind(&RandomGenerator::randomConfig, &randomGenerator)
@@ -128,7 +128,7 @@ std::tuple<
             RandomGenerator randomGenerator(domain, drakeRandomGenerator);
 
             auto startTime{ std::chrono::steady_clock::now() };
-            auto [regionsGBurIRIS, coverageGBurIRIS, burs] = GBurIRIS::GBurIRIS(
+            auto [regionsGBurIRIS, coverageGBurIRIS, burs, inflationStats] = GBurIRIS::GBurIRIS(
                 robot,
                 gBurIRISConfig,
                 std::bind(&RandomGenerator::randomConfig, &randomGenerator),
@@ -0,0 +1,104 @@
+#include "thread_pool.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+
+
+GBurIRIS::ThreadPool::ThreadPool(int numOfWorkers, std::function<void ()> onWorkerExit)
+  : onWorkerExit{ std::move(onWorkerExit) } {
+
+    if (numOfWorkers < 0) {
+        throw std::invalid_argument("Number of workers can not be negative!");
+    }
+
+    workers.reserve(numOfWorkers);
+    for (int i{}; i < numOfWorkers; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+
+
+GBurIRIS::ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock{ mutex };
+        stopping = true;
+    }
+    workAvailable.notify_all();
+
+    for (auto&& worker : workers) {
+        worker.join();
+    }
+}
+
+
+
+void GBurIRIS::ThreadPool::run(int numOfTasks, const std::function<void (int, int)>& task) {
+    {
+        std::lock_guard lock{ mutex };
+        this->task = &task;
+        this->numOfTasks = numOfTasks;
+        nextTask = 0;
+        numOfBusyWorkers = workers.size();
+        ++generation;
+    }
+    workAvailable.notify_all();
+
+    runTasks(workers.size());
+
+    std::unique_lock lock{ mutex };
+    workDone.wait(lock, [this]() { return numOfBusyWorkers == 0; });
+    this->task = nullptr;
+
+    if (taskException) {
+        std::rethrow_exception(std::exchange(taskException, nullptr));
+    }
+}
+
+
+
+void GBurIRIS::ThreadPool::workerLoop(int worker) {
+    std::uint64_t finishedGeneration{};
+
+    while (true) {
+        {
+            std::unique_lock lock{ mutex };
+            workAvailable.wait(lock, [this, finishedGeneration]() { return stopping || generation != finishedGeneration; });
+
+            if (stopping) {
+                break;
+            }
+
+            finishedGeneration = generation;
+        }
+
+        runTasks(worker);
+
+        {
+            std::lock_guard lock{ mutex };
+            if (--numOfBusyWorkers == 0) {
+                workDone.notify_one();
+            }
+        }
+    }
+
+    if (onWorkerExit) {
+        onWorkerExit();
+    }
+}
+
+
+
+void GBurIRIS::ThreadPool::runTasks(int worker) {
+    for (int i{ nextTask++ }; i < numOfTasks; i = nextTask++) {
+        try {
+            (*task)(i, worker);
+        } catch (...) {
+            std::lock_guard lock{ mutex };
+            if (!taskException) {
+                taskException = std::current_exception();
+            }
+        }
+    }
+}
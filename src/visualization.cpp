@@ -119,7 +119,6 @@ void GBurIRIS::visualization::Figure::visualize2dGeneralizedBur(
     auto&& qUpperBounds{ collisionChecker.plant().GetPositionUpperLimits() };
 
     GBur::GeneralizedBurConfig generalizedBurConfig{ gBur.getGeneralizedBurConfig() };
-    auto&& layers{ gBur.getLayers() };
 
 
     if (!plotColors) {
@@ -135,10 +134,11 @@ void GBurIRIS::visualization::Figure::visualize2dGeneralizedBur(
         std::vector<std::vector<double>> burLayerInPixels(
             generalizedBurConfig.numOfSpines, std::vector<double>(2)
         );
+        auto&& layer{ gBur.getLayer(j) };
         for (int i{}; i < generalizedBurConfig.numOfSpines; ++i) {
             burLayerInPixels.at(i) = {
-                (layers.at(i).at(j)(0) - qLowerBounds(0)) / (qUpperBounds(0) - qLowerBounds(0)) * numOfSamples,
-                (layers.at(i).at(j)(1) - qUpperBounds(1)) / (qLowerBounds(1) - qUpperBounds(1)) * numOfSamples
+                (layer(0, i) - qLowerBounds(0)) / (qUpperBounds(0) - qLowerBounds(0)) * numOfSamples,
+                (layer(1, i) - qUpperBounds(1)) / (qLowerBounds(1) - qUpperBounds(1)) * numOfSamples
             };
         }
 